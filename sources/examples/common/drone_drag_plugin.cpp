@@ -0,0 +1,175 @@
+#include "drone_drag_plugin.hpp"
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+namespace {
+
+const char* const kAttributes[] = {"linear", "quadratic", "angular", "rotor"};
+
+// インスタンスごとのデータ（mjData::plugin_data に保持する）
+struct DroneDrag {
+    int body = -1;
+    std::vector<int> actuators;  // 同じ機体のアクチュエータ
+    DroneDragParams params = {};
+};
+
+int plugin_slot = -1;
+
+// "a b c" または "a"（3軸共通）を読む
+void read_vector(const mjModel* m, int instance, const char* key, double* out, int n) {
+    const char* text = mj_getPluginConfig(m, instance, key);
+    for (int i = 0; i < n; i++) {
+        out[i] = 0;
+    }
+    if (!text || !text[0]) {
+        return;
+    }
+    char* end = nullptr;
+    int count = 0;
+    for (const char* p = text; count < n; p = end) {
+        double value = std::strtod(p, &end);
+        if (end == p) {
+            break;
+        }
+        out[count++] = value;
+    }
+    for (int i = count == 1 ? 1 : n; i < n; i++) {
+        out[i] = out[0];
+    }
+}
+
+// 機体（ルートボディが同じ）を駆動するアクチュエータか
+bool drives_body(const mjModel* m, int actuator, int root) {
+    int id = m->actuator_trnid[2 * actuator];
+    int body = -1;
+    switch (m->actuator_trntype[actuator]) {
+    case mjTRN_SITE:
+        body = m->site_bodyid[id];
+        break;
+    case mjTRN_BODY:
+        body = id;
+        break;
+    case mjTRN_JOINT:
+    case mjTRN_JOINTINPARENT:
+        body = m->jnt_bodyid[id];
+        break;
+    default:
+        return false;
+    }
+    return m->body_rootid[body] == root;
+}
+
+int drag_nstate(const mjModel*, int) {
+    return 0;
+}
+
+int drag_init(const mjModel* m, mjData* d, int instance) {
+    DroneDrag* drag = new DroneDrag();
+    for (int b = 0; b < m->nbody; b++) {
+        if (m->body_plugin[b] == instance) {
+            drag->body = b;
+            break;
+        }
+    }
+    if (drag->body < 0) {
+        std::cerr << "[ERROR] " << kDroneDragPluginName << ": instance " << instance << " is not attached to a body"
+                  << std::endl;
+        delete drag;
+        return -1;
+    }
+    int root = m->body_rootid[drag->body];
+    for (int u = 0; u < m->nu; u++) {
+        if (drives_body(m, u, root)) {
+            drag->actuators.push_back(u);
+        }
+    }
+    read_vector(m, instance, "linear", drag->params.linear, 3);
+    read_vector(m, instance, "quadratic", drag->params.quadratic, 3);
+    read_vector(m, instance, "angular", drag->params.angular, 3);
+    read_vector(m, instance, "rotor", &drag->params.rotor, 1);
+    d->plugin_data[instance] = reinterpret_cast<uintptr_t>(drag);
+    return 0;
+}
+
+void drag_destroy(mjData* d, int instance) {
+    delete reinterpret_cast<DroneDrag*>(d->plugin_data[instance]);
+    d->plugin_data[instance] = 0;
+}
+
+void drag_copy(mjData* dest, const mjModel*, const mjData* src, int instance) {
+    const DroneDrag* drag = reinterpret_cast<const DroneDrag*>(src->plugin_data[instance]);
+    dest->plugin_data[instance] = reinterpret_cast<uintptr_t>(new DroneDrag(*drag));
+}
+
+void drag_reset(const mjModel*, mjtNum*, void*, int) {
+}
+
+void drag_compute(const mjModel* m, mjData* d, int instance, int) {
+    const DroneDrag* drag = reinterpret_cast<const DroneDrag*>(d->plugin_data[instance]);
+    const DroneDragParams& p = drag->params;
+    const int b = drag->body;
+    const mjtNum* xmat = d->xmat + 9 * b;
+
+    // ボディ座標系の速度（風に対する相対速度）
+    mjtNum vel[6];
+    mj_objectVelocity(m, d, mjOBJ_XBODY, b, vel, 1);
+    mjtNum wind[3];
+    mju_mulMatTVec3(wind, xmat, m->opt.wind);
+    const mjtNum* w = vel;
+    mjtNum v[3] = {vel[3] - wind[0], vel[4] - wind[1], vel[5] - wind[2]};
+
+    mjtNum thrust = 0;
+    for (int u : drag->actuators) {
+        thrust += std::fabs(d->ctrl[u]);
+    }
+
+    mjtNum force_local[3], torque_local[3];
+    for (int i = 0; i < 3; i++) {
+        force_local[i] = -(p.linear[i] * v[i] + p.quadratic[i] * v[i] * std::fabs(v[i]));
+        torque_local[i] = -p.angular[i] * w[i];
+    }
+    force_local[0] -= p.rotor * thrust * v[0];
+    force_local[1] -= p.rotor * thrust * v[1];
+
+    mjtNum force[3], torque[3];
+    mju_mulMatVec3(force, xmat, force_local);
+    mju_mulMatVec3(torque, xmat, torque_local);
+    mj_applyFT(m, d, force, torque, d->xpos + 3 * b, b, d->qfrc_passive);
+}
+
+}  // namespace
+
+bool register_drone_drag_plugin() {
+    if (plugin_slot >= 0) {
+        return true;
+    }
+    mjpPlugin plugin;
+    mjp_defaultPlugin(&plugin);
+    plugin.name = kDroneDragPluginName;
+    plugin.capabilityflags = mjPLUGIN_PASSIVE;
+    plugin.nattribute = sizeof(kAttributes) / sizeof(kAttributes[0]);
+    plugin.attributes = kAttributes;
+    plugin.nstate = drag_nstate;
+    plugin.init = drag_init;
+    plugin.destroy = drag_destroy;
+    plugin.copy = drag_copy;
+    plugin.reset = drag_reset;
+    plugin.compute = drag_compute;
+    plugin_slot = mjp_registerPlugin(&plugin);
+    if (plugin_slot < 0) {
+        std::cerr << "[ERROR] Failed to register plugin: " << kDroneDragPluginName << std::endl;
+        return false;
+    }
+    return true;
+}
+
+DroneDragParams* drone_drag_params(const mjModel* model, mjData* data, int instance) {
+    if (plugin_slot < 0 || instance < 0 || instance >= model->nplugin || model->plugin[instance] != plugin_slot) {
+        return nullptr;
+    }
+    return &reinterpret_cast<DroneDrag*>(data->plugin_data[instance])->params;
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <mujoco/mujoco.h>
+
+/**
+ * @file drone_drag_plugin.hpp
+ * @brief ドローン1機ぶんの空気抵抗をまとめて与える受動力プラグイン
+ *
+ * MuJoCo 組み込みの流体モデル（fluidshape="ellipsoid"）はジオムごとに楕円体の力を計算するが、
+ * このプラグインはボディ座標系での集中定数モデルで、機体1つにつき1回だけ力を加える。
+ * - 並進: F_i = -(linear_i * v_i + quadratic_i * v_i * |v_i|)   （v は opt.wind に対する相対速度）
+ * - 回転: T_i = -angular_i * w_i
+ * - ロータ抵抗: F_xy = -rotor * (機体のアクチュエータの ctrl の和) * v_xy
+ *
+ * MJCF での使い方（mj_loadXML の前に register_drone_drag_plugin() を呼ぶ）:
+ * @code{.xml}
+ * <extension>
+ *   <plugin plugin="hakoniwa.drone_drag">
+ *     <instance name="drag">
+ *       <config key="linear" value="1e-4 1e-4 1e-4"/>
+ *       <config key="quadratic" value="0.006 0.006 0.058"/>
+ *       <config key="angular" value="2e-4 2e-4 4e-4"/>
+ *       <config key="rotor" value="0.01"/>
+ *     </instance>
+ *   </plugin>
+ * </extension>
+ * <body name="drone_base"> <plugin instance="drag"/> ... </body>
+ * @endcode
+ * 値が1つの場合は3軸に同じ値を使う。省略した項目は 0 になる。
+ */
+
+constexpr const char* kDroneDragPluginName = "hakoniwa.drone_drag";
+
+/**
+ * @brief 抗力係数（ボディ座標系）
+ */
+struct DroneDragParams {
+    double linear[3];       ///< 並進の線形抵抗 [N/(m/s)]
+    double quadratic[3];    ///< 並進の2乗抵抗 [N/(m/s)^2]
+    double angular[3];      ///< 回転の線形抵抗 [Nm/(rad/s)]
+    double rotor;           ///< ロータ抵抗 [N/(m/s) / ctrl]
+};
+
+/**
+ * @brief プラグインを MuJoCo に登録する（複数回呼んでもよい）
+ * @return 登録済みまたは登録に成功した場合 true
+ */
+bool register_drone_drag_plugin();
+
+/**
+ * @brief mjData ごとの係数を取得する（実行中に書き換えると次のステップから反映される）
+ * @param model MuJoCoのモデルデータ
+ * @param data シミュレーションデータ
+ * @param instance プラグインのインスタンス番号
+ * @return このプラグインのインスタンスでない場合 nullptr
+ */
+DroneDragParams* drone_drag_params(const mjModel* model, mjData* data, int instance);
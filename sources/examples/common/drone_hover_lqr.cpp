@@ -0,0 +1,138 @@
+#include "drone_hover_lqr.hpp"
+#include "mujoco_linearizer.hpp"
+#include "mujoco_lqr.hpp"
+#include <cmath>
+#include <iostream>
+
+// LQRの重み（状態: 位置, 姿勢, 並進速度, 角速度 / 入力: 推力[N]）
+static const double kStateWeight[kDroneLqrNx] = {
+    20, 20, 40,
+    4, 4, 2,
+    2, 2, 4,
+    0.2, 0.2, 0.2,
+};
+static const double kInputWeight = 5.0;
+
+static double bin_yaw(int bin) {
+    return -M_PI + 2 * M_PI * bin / kDroneLqrYawBins;
+}
+
+static void yaw_to_quat(double yaw, double quat[4]) {
+    quat[0] = std::cos(0.5 * yaw);
+    quat[1] = 0;
+    quat[2] = 0;
+    quat[3] = std::sin(0.5 * yaw);
+}
+
+// drone_base のフリージョイントの ID（見つからない場合はエラーを出力して -1）
+static int base_joint_id(const mjModel* model) {
+    int body_id = resolve_object_id(model, mjOBJ_BODY, "drone_base");
+    if (body_id == -1) {
+        return -1;
+    }
+    int joint_id = model->body_jntadr[body_id];
+    if (joint_id == -1 || model->jnt_type[joint_id] != mjJNT_FREE) {
+        std::cerr << "[ERROR] drone_base must have a free joint" << std::endl;
+        return -1;
+    }
+    return joint_id;
+}
+
+DroneHoverLqr::DroneHoverLqr() : table_() {
+    double origin[3] = {0, 0, 0};
+    set_target(origin, 0);
+}
+
+bool DroneHoverLqr::build(const mjModel* model, int nworker) {
+    int joint_id = base_joint_id(model);
+    if (joint_id == -1) {
+        return false;
+    }
+    if (2 * model->nv + model->na != kDroneLqrNx || model->nu != kDroneLqrNu) {
+        std::cerr << "[ERROR] Unexpected model size for hover LQR: nx=" << 2 * model->nv + model->na
+                  << ", nu=" << model->nu << std::endl;
+        return false;
+    }
+
+    double hover_thrust = mj_getTotalmass(model) * -model->opt.gravity[2] / model->nu;
+    table_.u_hover.fill(hover_thrust);
+
+    double Q[kDroneLqrNx * kDroneLqrNx] = {0};
+    double R[kDroneLqrNu * kDroneLqrNu] = {0};
+    for (int i = 0; i < kDroneLqrNx; i++) {
+        Q[i * kDroneLqrNx + i] = kStateWeight[i];
+    }
+    for (int i = 0; i < kDroneLqrNu; i++) {
+        R[i * kDroneLqrNu + i] = kInputWeight;
+    }
+
+    // ヨー角ごとにホバリング状態で線形化し、ゲインを求める
+    Linearizer linearizer(model, nworker);
+    Linearization lin;
+    mjData* data = mj_makeData(model);
+    JointView base = JointView::bind(model, data, joint_id);
+    bool ok = true;
+    for (int bin = 0; bin < kDroneLqrYawBins && ok; bin++) {
+        mj_resetData(model, data);
+        yaw_to_quat(bin_yaw(bin), base.qpos().data() + 3);
+        for (int i = 0; i < model->nu; i++) {
+            data->ctrl[i] = hover_thrust;
+        }
+        mj_forward(model, data);
+        linearizer.compute(data, lin);
+        ok = solve_discrete_lqr(lin.A.data(), lin.B.data(), Q, R, kDroneLqrNx, kDroneLqrNu,
+                                table_.K[bin].data());
+    }
+    mj_deleteData(data);
+    if (!ok) {
+        std::cerr << "[ERROR] Failed to build hover LQR gain table" << std::endl;
+    }
+    return ok;
+}
+
+void DroneHoverLqr::set_target(const double pos[3], double yaw) {
+    for (int i = 0; i < 3; i++) {
+        target_pos_[i] = pos[i];
+    }
+    yaw_to_quat(yaw, target_quat_);
+}
+
+ConstJointView DroneHoverLqr::bind_base(const mjModel* model, const mjData* data) {
+    return ConstJointView::bind(model, data, base_joint_id(model));
+}
+
+void DroneHoverLqr::compute(const ConstJointView& base, double* ctrl) const {
+    const double* pos = base.qpos().data();
+    const double* quat = pos + 3;
+    const double* vel = base.qvel().data();
+
+    // 状態偏差（mj_differentiatePos と同じ接空間の定義）
+    double dx[kDroneLqrNx];
+    for (int i = 0; i < 3; i++) {
+        dx[i] = pos[i] - target_pos_[i];
+    }
+    mju_subQuat(dx + 3, quat, target_quat_);
+    for (int i = 0; i < 6; i++) {
+        dx[6 + i] = vel[i];
+    }
+
+    // 現在のヨー角を挟む2つのビンを線形補間する
+    double yaw = std::atan2(2 * (quat[0] * quat[3] + quat[1] * quat[2]),
+                            1 - 2 * (quat[2] * quat[2] + quat[3] * quat[3]));
+    double t = (yaw + M_PI) / (2 * M_PI) * kDroneLqrYawBins;
+    int bin0 = static_cast<int>(std::floor(t));
+    double w = t - bin0;
+    bin0 = ((bin0 % kDroneLqrYawBins) + kDroneLqrYawBins) % kDroneLqrYawBins;
+    int bin1 = (bin0 + 1) % kDroneLqrYawBins;
+    const double* K0 = table_.K[bin0].data();
+    const double* K1 = table_.K[bin1].data();
+
+    for (int r = 0; r < kDroneLqrNu; r++) {
+        double u0 = 0, u1 = 0;
+        for (int c = 0; c < kDroneLqrNx; c++) {
+            u0 += K0[r * kDroneLqrNx + c] * dx[c];
+            u1 += K1[r * kDroneLqrNx + c] * dx[c];
+        }
+        ctrl[r] = table_.u_hover[r] - ((1 - w) * u0 + w * u1);
+    }
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <mujoco/mujoco.h>
+#include <array>
+#include "mujoco_state_view.hpp"
+
+/**
+ * @file drone_hover_lqr.hpp
+ * @brief drone.xml 用のホバリングLQR（位置・姿勢）制御器
+ *
+ * ホバリング状態での線形化から求めたLQRゲインを、ヨー角ごとの固定サイズのテーブルに保持する。
+ * 実行時はテーブル参照と線形補間だけを行うため、1ステップの計算量は数百FLOP程度となる。
+ * ゲインテーブルは読み取り専用なので、多数のドローンで1つの制御器を共有できる。
+ * 機体の状態は呼び出し側がドローンごとに bind_base() で1回だけ束縛したビューから読む。
+ */
+
+constexpr int kDroneLqrNx = 12;        ///< 状態の次元（フリージョイント: 位置・姿勢 6 + 速度 6）
+constexpr int kDroneLqrNu = 4;         ///< 入力の次元（ロータ4つ）
+constexpr int kDroneLqrYawBins = 16;   ///< ヨー角方向のテーブル分割数
+
+/**
+ * @brief ヨー角で索引付けしたLQRゲインテーブル
+ */
+struct DroneLqrGainTable {
+    std::array<std::array<double, kDroneLqrNu * kDroneLqrNx>, kDroneLqrYawBins> K;  ///< ゲイン (nu x nx, 行優先)
+    std::array<double, kDroneLqrNu> u_hover;   ///< ホバリング推力
+};
+
+class DroneHoverLqr {
+public:
+    DroneHoverLqr();
+
+    /**
+     * @brief ホバリング状態の線形化からゲインテーブルを作成する（起動時に1回だけ呼ぶ）
+     * @param model drone.xml のモデルデータ
+     * @param nworker 線形化に使うワーカー数
+     * @return 成功した場合 true
+     */
+    bool build(const mjModel* model, int nworker);
+
+    /**
+     * @brief 目標位置とヨー角を設定する
+     * @param pos 目標位置（ワールド座標）
+     * @param yaw 目標ヨー角 [rad]
+     */
+    void set_target(const double pos[3], double yaw);
+
+    /**
+     * @brief drone_base のフリージョイントのビューを束縛する（ドローンごとに1回だけ呼ぶ）
+     * @param model drone.xml のモデルデータ
+     * @param data 束縛するシミュレーションデータ
+     * @return 見つからない・フリージョイントでない場合は無効なビュー（valid() == false）
+     */
+    static ConstJointView bind_base(const mjModel* model, const mjData* data);
+
+    /**
+     * @brief 現在の状態から制御入力を計算する
+     * @param base bind_base() で束縛した drone_base のビュー
+     * @param ctrl 出力先（nu 要素）
+     */
+    void compute(const ConstJointView& base, double* ctrl) const;
+
+    const DroneLqrGainTable& table() const { return table_; }
+
+private:
+    DroneLqrGainTable table_;
+    double target_pos_[3];
+    double target_quat_[4];
+};
@@ -0,0 +1,90 @@
+#include "mujoco_adaptive_step.hpp"
+#include "mujoco_warnings.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+
+int integrator_order(const mjModel* model) {
+    return model->opt.integrator == mjINT_RK4 ? 4 : 1;
+}
+
+}  // namespace
+
+AdaptiveStepper::AdaptiveStepper(const AdaptiveStepOptions& options) : options_(options) {}
+
+double AdaptiveStepper::estimate_error(const mjModel* model, const mjData* data) {
+    // 採用する h での1回の誤差は 差 * 2^p / (2^p - 1)
+    const double order = std::pow(2.0, integrator_order(model));
+    const double scale = order / (order - 1.0);
+    mj_differentiatePos(model, dq_.data(), 1.0, half_qpos_.data(), data->qpos);
+    double error = 0;
+    for (int i = 0; i < model->nv; i++) {
+        double dq = std::fabs(dq_[i]) * scale;
+        double dv = std::fabs(data->qvel[i] - half_qvel_[i]) * scale;
+        double v = std::max(std::fabs(data->qvel[i]), std::fabs(half_qvel_[i]));
+        error = std::max(error, dq / options_.position_tolerance);
+        error = std::max(error, dv / (options_.velocity_tolerance + options_.relative_tolerance * v));
+    }
+    return std::isfinite(error) ? error : std::numeric_limits<double>::infinity();
+}
+
+double AdaptiveStepper::step(mjModel* model, mjData* data) {
+    const int size = mj_stateSize(model, mjSTATE_INTEGRATION);
+    if (static_cast<int>(state_.size()) != size || static_cast<int>(half_qpos_.size()) != model->nq ||
+        static_cast<int>(dq_.size()) != model->nv) {
+        state_.resize(size);
+        half_qpos_.resize(model->nq);
+        half_qvel_.resize(model->nv);
+        dq_.resize(model->nv);
+    }
+    mj_getState(model, data, state_.data(), mjSTATE_INTEGRATION);
+
+    // 試行中は警告の回数を 0 にして判定し、最後に元の回数へ足し戻す
+    int saved_warnings[kNumResetWarnings];
+    for (int i = 0; i < kNumResetWarnings; i++) {
+        saved_warnings[i] = data->warning[kResetWarnings[i]].number;
+    }
+
+    double h = std::min(std::max(model->opt.timestep, options_.min_timestep), options_.max_timestep);
+    while (true) {
+        // h/2 で2回
+        clear_reset_warnings(data);
+        model->opt.timestep = 0.5 * h;
+        mj_step(model, data);
+        mj_step(model, data);
+        mju_copy(half_qpos_.data(), data->qpos, model->nq);
+        mju_copy(half_qvel_.data(), data->qvel, model->nv);
+        bool reset = has_reset_warning(data);
+
+        // h で1回（採用する場合はこの結果）
+        mj_setState(model, data, state_.data(), mjSTATE_INTEGRATION);
+        clear_reset_warnings(data);
+        model->opt.timestep = h;
+        mj_step(model, data);
+        mj_steps_ += 3;
+        reset = reset || has_reset_warning(data);
+
+        double error = reset ? std::numeric_limits<double>::infinity() : estimate_error(model, data);
+        last_error_ = error;
+        double scale = error > 0 ? options_.safety * std::pow(error, -1.0 / (integrator_order(model) + 1))
+                                 : options_.max_scale;
+        scale = std::min(std::max(scale, options_.min_scale), options_.max_scale);
+
+        if (error <= 1.0 || h <= options_.min_timestep) {
+            accepted_++;
+            double next = error <= 1.0 ? std::min(h * scale, options_.max_timestep) : h;
+            model->opt.timestep = std::max(next, options_.min_timestep);
+            for (int i = 0; i < kNumResetWarnings; i++) {
+                data->warning[kResetWarnings[i]].number += saved_warnings[i];
+            }
+            return h;
+        }
+
+        // やり直し
+        rejected_++;
+        mj_setState(model, data, state_.data(), mjSTATE_INTEGRATION);
+        h = std::max(h * std::min(scale, 1.0), options_.min_timestep);
+    }
+}
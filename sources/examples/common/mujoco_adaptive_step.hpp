@@ -0,0 +1,85 @@
+#pragma once
+
+#include <mujoco/mujoco.h>
+#include <vector>
+
+/**
+ * @file mujoco_adaptive_step.hpp
+ * @brief 局所誤差の推定（ステップ二分法）による可変 timestep
+ *
+ * 1ステップごとに、現在の timestep h での1回の mj_step と、h/2 での2回の mj_step の結果を比べて
+ * 局所誤差を推定する（積分器の次数 p に対し、採用する h での1回の誤差 ≈ 差 * 2^p / (2^p - 1)）。
+ * 誤差が許容値以内なら h での1回の結果を採用し、次の h を誤差に応じて伸ばす（滑らかな巡航中）。
+ * 許容値を超えたら状態を戻して h を縮めてやり直す（衝突や急な機動）。
+ *
+ * 採用するのは h での1回の mj_step の結果なので、同じ timestep と入力を与えれば
+ * InputReplay でビット単位で再現できる（InputRecorder::record_timestep で timestep を記録する）。
+ *
+ * 誤差の尺度（要素ごとの最大値が 1 以下で採用）:
+ *   位置（mj_differentiatePos による nv 次元の差）: |dq| / position_tolerance
+ *   速度: |dv| / (velocity_tolerance + relative_tolerance * |v|)
+ *
+ * @note 1回の採用に mj_step を3回（やり直し時はさらに）呼ぶため、ステップ数の削減が
+ *       計算時間の削減になるのは、h を3倍以上に伸ばせる場面に限られる。
+ * @note model->opt.timestep を次に試す h に書き換える。StepWatchdog とは併用しない
+ *       （発散は誤差が有限でないものとして、この中で縮めてやり直す）。
+ */
+
+/**
+ * @brief 可変 timestep の設定
+ */
+struct AdaptiveStepOptions {
+    double min_timestep = 1e-5;         ///< 下限 [s]（ここまで縮めても誤差が大きい場合はそのまま採用する）
+    double max_timestep = 0.02;         ///< 上限 [s]
+    double position_tolerance = 1e-5;   ///< 位置の許容誤差 [m, rad]
+    double velocity_tolerance = 1e-4;   ///< 速度の許容誤差 [m/s, rad/s]
+    double relative_tolerance = 1e-4;   ///< 速度の相対許容誤差
+    double safety = 0.9;                ///< 次の h を求める際の安全係数
+    double min_scale = 0.2;             ///< 1回で h を縮める最小倍率
+    double max_scale = 2.0;             ///< 1回で h を伸ばす最大倍率
+};
+
+class AdaptiveStepper {
+public:
+    explicit AdaptiveStepper(const AdaptiveStepOptions& options = AdaptiveStepOptions());
+
+    /**
+     * @brief 誤差が許容値以内になる timestep で1ステップ進める
+     *
+     * ctrl / xfrc_applied などの入力は呼ぶ前に設定しておく（やり直しでも同じ入力を使う）。
+     * モデルの次元が変わった場合（ホットリロードなど）は作業領域を確保し直す。
+     *
+     * @param model モデル（opt.timestep を書き換える）
+     * @param data シミュレーションデータ
+     * @return 採用したステップの timestep [s]（data->time はこの分だけ進む）
+     */
+    double step(mjModel* model, mjData* data);
+
+    const AdaptiveStepOptions& options() const { return options_; }
+
+    /**
+     * @brief 最後に推定した誤差（許容値で割ったもの）
+     */
+    double last_error() const { return last_error_; }
+
+    long long accepted() const { return accepted_; }
+    long long rejected() const { return rejected_; }
+
+    /**
+     * @brief これまでに呼んだ mj_step の回数（誤差推定の分を含む）
+     */
+    long long mj_steps() const { return mj_steps_; }
+
+private:
+    double estimate_error(const mjModel* model, const mjData* data);
+
+    AdaptiveStepOptions options_;
+    std::vector<mjtNum> state_;         // ステップ前の状態（mjSTATE_INTEGRATION）
+    std::vector<mjtNum> half_qpos_;     // h/2 x 2 の結果
+    std::vector<mjtNum> half_qvel_;
+    std::vector<mjtNum> dq_;
+    double last_error_ = 0;
+    long long accepted_ = 0;
+    long long rejected_ = 0;
+    long long mj_steps_ = 0;
+};
@@ -0,0 +1,242 @@
+#include "mujoco_async_logger.hpp"
+#include "mujoco_state_view.hpp"
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <utility>
+
+namespace {
+
+size_t round_up_pow2(size_t n) {
+    size_t capacity = 1;
+    while (capacity < n) {
+        capacity <<= 1;
+    }
+    return capacity;
+}
+
+const char* record_type_name(LogRecordType type) {
+    switch (type) {
+        case LogRecordType::Joint: return "joint";
+        case LogRecordType::Body: return "body";
+        case LogRecordType::Actuator: return "actuator";
+    }
+    return "unknown";
+}
+
+void append_array(std::string& line, const char* key, const double* values, int n) {
+    char buf[32];
+    line += ",\"";
+    line += key;
+    line += "\":[";
+    for (int i = 0; i < n; i++) {
+        std::snprintf(buf, sizeof(buf), i == 0 ? "%.9g" : ",%.9g", values[i]);
+        line += buf;
+    }
+    line += ']';
+}
+
+}  // namespace
+
+LogRing::LogRing(size_t capacity)
+    : buffer_(round_up_pow2(capacity < 2 ? 2 : capacity)), mask_(buffer_.size() - 1), head_(0), tail_(0) {}
+
+bool LogRing::push(const LogRecord& record) {
+    size_t head = head_.load(std::memory_order_relaxed);
+    if (head - tail_.load(std::memory_order_acquire) == buffer_.size()) {
+        return false;
+    }
+    buffer_[head & mask_] = record;
+    head_.store(head + 1, std::memory_order_release);
+    return true;
+}
+
+bool LogRing::pop(LogRecord& record) {
+    size_t tail = tail_.load(std::memory_order_relaxed);
+    if (tail == head_.load(std::memory_order_acquire)) {
+        return false;
+    }
+    record = buffer_[tail & mask_];
+    tail_.store(tail + 1, std::memory_order_release);
+    return true;
+}
+
+LogRateLimiter::LogRateLimiter(double rate_hz) : period_(rate_hz > 0 ? 1.0 / rate_hz : 0.0), next_(0.0) {}
+
+bool LogRateLimiter::allow(double time) {
+    if (time < next_ - period_) {
+        next_ = time;  // リセットなどで時刻が戻った
+    }
+    if (time < next_) {
+        return false;
+    }
+    next_ += period_;
+    if (next_ <= time) {
+        next_ = time + period_;  // 大きく遅れた場合は追いつかせない
+    }
+    return true;
+}
+
+JsonLinesSink::JsonLinesSink(const std::string& path) : out_(path) {
+    if (!out_) {
+        std::cerr << "[ERROR] Failed to open log file: " << path << std::endl;
+    }
+}
+
+void JsonLinesSink::write(const LogRecord& record, const std::string& name) {
+    char buf[64];
+    std::snprintf(buf, sizeof(buf), "{\"t\":%.9g,\"type\":\"", record.time);
+    line_ = buf;
+    line_ += record_type_name(record.type);
+    line_ += "\",\"name\":\"";
+    line_ += name;
+    line_ += '"';
+    switch (record.type) {
+        case LogRecordType::Joint:
+            append_array(line_, "qpos", record.values, record.npos);
+            append_array(line_, "qvel", record.values + record.npos, record.nvel);
+            break;
+        case LogRecordType::Body:
+            append_array(line_, "xpos", record.values, 3);
+            append_array(line_, "xquat", record.values + 3, 4);
+            break;
+        case LogRecordType::Actuator:
+            append_array(line_, "ctrl", record.values, 1);
+            append_array(line_, "force", record.values + 1, 1);
+            break;
+    }
+    line_ += "}\n";
+    out_ << line_;
+}
+
+void JsonLinesSink::flush() {
+    out_.flush();
+}
+
+AsyncLogger::AsyncLogger(const mjModel* model, std::unique_ptr<LogSink> sink, double rate_hz, size_t capacity)
+    : model_(model), sink_(std::move(sink)), limiter_(rate_hz), ring_(capacity), dropped_(0), running_(false) {}
+
+AsyncLogger::~AsyncLogger() {
+    stop();
+}
+
+bool AsyncLogger::add(LogRecordType type, mjtObj obj, const std::string& name) {
+    int id = mj_name2id(model_, obj, name.c_str());
+    if (id == -1) {
+        std::cerr << "[ERROR] " << record_type_name(type) << " not found: " << name << std::endl;
+        return false;
+    }
+    entries_.push_back({type, obj, id});
+    names_.push_back(name);
+    return true;
+}
+
+bool AsyncLogger::add_joint(const std::string& name) {
+    return add(LogRecordType::Joint, mjOBJ_JOINT, name);
+}
+
+bool AsyncLogger::add_body(const std::string& name) {
+    return add(LogRecordType::Body, mjOBJ_BODY, name);
+}
+
+bool AsyncLogger::add_actuator(const std::string& name) {
+    return add(LogRecordType::Actuator, mjOBJ_ACTUATOR, name);
+}
+
+void AsyncLogger::rebind(const mjModel* model) {
+    model_ = model;
+    for (size_t i = 0; i < entries_.size(); i++) {
+        Entry& entry = entries_[i];
+        int id = mj_name2id(model_, entry.obj, names_[i].c_str());
+        if (id == -1 && entry.id != -1) {
+            std::cerr << "[ERROR] " << record_type_name(entry.type) << " not found after reload: " << names_[i]
+                      << std::endl;
+        }
+        entry.id = id;
+    }
+}
+
+void AsyncLogger::start() {
+    if (running_ || !sink_) {
+        return;
+    }
+    running_ = true;
+    thread_ = std::thread(&AsyncLogger::run, this);
+}
+
+void AsyncLogger::stop() {
+    if (!running_) {
+        return;
+    }
+    running_ = false;
+    thread_.join();
+    if (dropped() > 0) {
+        std::cerr << "[ERROR] Log records dropped: " << dropped() << std::endl;
+    }
+}
+
+void AsyncLogger::fill(const Entry& entry, const mjData* data, LogRecord& record) const {
+    int id = entry.id;
+    switch (entry.type) {
+        case LogRecordType::Joint: {
+            // 関節の種類ごとに qpos / qvel の要素数が異なるためアドレスで切り出す
+            int type = model_->jnt_type[id];
+            int nq = joint_qpos_size(type);
+            int nv = joint_dof_size(type);
+            mju_copy(record.values, data->qpos + model_->jnt_qposadr[id], nq);
+            mju_copy(record.values + nq, data->qvel + model_->jnt_dofadr[id], nv);
+            record.npos = static_cast<uint8_t>(nq);
+            record.nvel = static_cast<uint8_t>(nv);
+            break;
+        }
+        case LogRecordType::Body:
+            mju_copy3(record.values, data->xpos + 3 * id);
+            mju_copy4(record.values + 3, data->xquat + 4 * id);
+            break;
+        case LogRecordType::Actuator:
+            record.values[0] = data->ctrl[id];
+            record.values[1] = data->actuator_force[id];
+            break;
+    }
+}
+
+void AsyncLogger::log(const mjData* data) {
+    if (!running_.load(std::memory_order_relaxed) || !limiter_.allow(data->time)) {
+        return;
+    }
+    LogRecord record;
+    record.time = data->time;
+    record.npos = 0;
+    record.nvel = 0;
+    for (size_t i = 0; i < entries_.size(); i++) {
+        if (entries_[i].id == -1) {
+            continue;
+        }
+        record.type = entries_[i].type;
+        record.name = static_cast<uint16_t>(i);
+        fill(entries_[i], data, record);
+        if (!ring_.push(record)) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+}
+
+void AsyncLogger::run() {
+    LogRecord record;
+    for (;;) {
+        // 停止要求を先に読み、その後にキューを空にすることで最後のレコードも書き出す
+        bool stopping = !running_.load();
+        bool wrote = false;
+        while (ring_.pop(record)) {
+            sink_->write(record, names_[record.name]);
+            wrote = true;
+        }
+        if (wrote) {
+            sink_->flush();
+        }
+        if (stopping) {
+            break;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+}
@@ -0,0 +1,231 @@
+#pragma once
+
+#include <mujoco/mujoco.h>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @file mujoco_async_logger.hpp
+ * @brief シミュレーション状態の非同期ロガー
+ *
+ * シミュレーションスレッドは関節・剛体・アクチュエータの値を固定長のバイナリレコードとして
+ * ロックフリーのリングバッファ（単一生産者・単一消費者）へ積むだけで、文字列の整形と出力は
+ * バックグラウンドスレッドが行う。mujoco_debug の `print_*` 関数と異なり、ステップ周期で呼んでも
+ * ステップ時間にほとんど影響しない。
+ *
+ * - 記録周期はシミュレーション時刻で間引く（LogRateLimiter）
+ * - バッファが一杯の場合はレコードを捨てて件数だけ数える（シミュレーションを待たせない）
+ * - 出力先は LogSink を差し替えられる（標準は JSON Lines）
+ */
+
+/**
+ * @brief レコードの種類
+ */
+enum class LogRecordType : uint8_t {
+    Joint,     ///< qpos, qvel
+    Body,      ///< xpos(3), xquat(4)
+    Actuator,  ///< ctrl, actuator_force
+};
+
+/**
+ * @brief 固定長のログレコード（トリビアルコピー可能）
+ */
+struct LogRecord {
+    static constexpr int kMaxValues = 13;  ///< フリージョイントの qpos(7) + qvel(6)
+
+    LogRecordType type;
+    uint8_t npos;        ///< values のうち位置成分の数（Joint の場合）
+    uint8_t nvel;        ///< values のうち速度成分の数（Joint の場合）
+    uint16_t name;       ///< 登録名テーブルの添字
+    double time;         ///< シミュレーション時刻
+    double values[kMaxValues];
+};
+
+/**
+ * @brief ロックフリーのリングバッファ（単一生産者・単一消費者）
+ */
+class LogRing {
+public:
+    /**
+     * @param capacity 容量（2のべき乗に切り上げる）
+     */
+    explicit LogRing(size_t capacity);
+
+    /**
+     * @brief 生産者側：レコードを積む
+     * @return 一杯の場合 false
+     */
+    bool push(const LogRecord& record);
+
+    /**
+     * @brief 消費者側：レコードを1件取り出す
+     * @return 空の場合 false
+     */
+    bool pop(LogRecord& record);
+
+private:
+    std::vector<LogRecord> buffer_;
+    size_t mask_;
+    alignas(64) std::atomic<size_t> head_;  // 次に書く位置（生産者のみ更新）
+    alignas(64) std::atomic<size_t> tail_;  // 次に読む位置（消費者のみ更新）
+};
+
+/**
+ * @brief シミュレーション時刻で記録周期を間引く
+ */
+class LogRateLimiter {
+public:
+    /**
+     * @param rate_hz 記録周期 [Hz]（0以下の場合は毎回記録する）
+     */
+    explicit LogRateLimiter(double rate_hz);
+
+    /**
+     * @brief この時刻に記録してよいか判定する
+     * @param time シミュレーション時刻
+     */
+    bool allow(double time);
+
+private:
+    double period_;
+    double next_;
+};
+
+/**
+ * @brief ログの出力先
+ */
+class LogSink {
+public:
+    virtual ~LogSink() = default;
+
+    /**
+     * @brief 1レコードを出力する（バックグラウンドスレッドから呼ばれる）
+     * @param record レコード
+     * @param name 登録名
+     */
+    virtual void write(const LogRecord& record, const std::string& name) = 0;
+
+    /**
+     * @brief 溜まった出力を書き出す（キューが空になったときに呼ばれる）
+     */
+    virtual void flush() {}
+};
+
+/**
+ * @brief JSON Lines 形式（1レコード1行）でファイルへ出力する
+ *
+ * 例: {"t":0.1,"type":"joint","name":"left_wheel_hinge","qpos":[1.2],"qvel":[3.4]}
+ */
+class JsonLinesSink : public LogSink {
+public:
+    /**
+     * @param path 出力ファイルのパス
+     */
+    explicit JsonLinesSink(const std::string& path);
+
+    /**
+     * @brief ファイルを開けたか
+     */
+    bool is_open() const { return out_.is_open(); }
+
+    void write(const LogRecord& record, const std::string& name) override;
+    void flush() override;
+
+private:
+    std::ofstream out_;
+    std::string line_;
+};
+
+/**
+ * @brief 非同期ロガー
+ *
+ * 記録対象を名前で登録してから start() し、シミュレーションスレッドから log() を呼ぶ。
+ */
+class AsyncLogger {
+public:
+    /**
+     * @param model 記録対象のモデル
+     * @param sink 出力先
+     * @param rate_hz 記録周期 [Hz]（シミュレーション時刻基準）
+     * @param capacity リングバッファの容量（レコード数）
+     */
+    AsyncLogger(const mjModel* model, std::unique_ptr<LogSink> sink, double rate_hz, size_t capacity = 4096);
+    ~AsyncLogger();
+
+    AsyncLogger(const AsyncLogger&) = delete;
+    AsyncLogger& operator=(const AsyncLogger&) = delete;
+
+    /**
+     * @brief 記録する関節を登録する（start() 前に呼ぶ）
+     * @return 見つからない場合 false
+     */
+    bool add_joint(const std::string& name);
+
+    /**
+     * @brief 記録する剛体を登録する（start() 前に呼ぶ）
+     * @return 見つからない場合 false
+     */
+    bool add_body(const std::string& name);
+
+    /**
+     * @brief 記録するアクチュエータを登録する（start() 前に呼ぶ）
+     * @return 見つからない場合 false
+     */
+    bool add_actuator(const std::string& name);
+
+    /**
+     * @brief 登録した対象の ID を名前で引き直す（モデルを再コンパイルした後、log() と同じロックの下で呼ぶ）
+     *
+     * 見つからなくなった対象は記録しない（再び見つかれば記録を再開する）。
+     * @param model 再コンパイル後のモデル
+     */
+    void rebind(const mjModel* model);
+
+    /**
+     * @brief バックグラウンドの整形スレッドを開始する
+     */
+    void start();
+
+    /**
+     * @brief 残りのレコードを書き出して整形スレッドを停止する
+     */
+    void stop();
+
+    /**
+     * @brief 登録した対象の現在値を積む（シミュレーションスレッドから呼ぶ、ロック・メモリ確保なし）
+     * @param data シミュレーションデータ
+     */
+    void log(const mjData* data);
+
+    /**
+     * @brief バッファが一杯で捨てたレコード数
+     */
+    size_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+private:
+    struct Entry {
+        LogRecordType type;
+        mjtObj obj;
+        int id;  // -1: 現在のモデルに無い
+    };
+
+    bool add(LogRecordType type, mjtObj obj, const std::string& name);
+    void fill(const Entry& entry, const mjData* data, LogRecord& record) const;
+    void run();
+
+    const mjModel* model_;
+    std::unique_ptr<LogSink> sink_;
+    LogRateLimiter limiter_;
+    LogRing ring_;
+    std::vector<Entry> entries_;
+    std::vector<std::string> names_;
+    std::atomic<size_t> dropped_;
+    std::atomic<bool> running_;
+    std::thread thread_;
+};
@@ -0,0 +1,182 @@
+#include "mujoco_collision_filter.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <random>
+#include <utility>
+#include "mujoco_timer.hpp"
+
+namespace {
+
+// MuJoCo の既定のフィルタを通過する、同じロボット内のジオム対か
+bool is_candidate(const mjModel* m, int g1, int g2) {
+    int b1 = m->geom_bodyid[g1];
+    int b2 = m->geom_bodyid[g2];
+    int root = m->body_rootid[b1];
+    if (root == 0 || root != m->body_rootid[b2]) {
+        return false;
+    }
+    if (!((m->geom_contype[g1] & m->geom_conaffinity[g2]) || (m->geom_contype[g2] & m->geom_conaffinity[g1]))) {
+        return false;
+    }
+    // 同じ剛体（溶接されたボディ）と、親子の剛体は MuJoCo が除外する
+    int w1 = m->body_weldid[b1];
+    int w2 = m->body_weldid[b2];
+    if (w1 == w2) {
+        return false;
+    }
+    int p1 = m->body_weldid[m->body_parentid[w1]];
+    int p2 = m->body_weldid[m->body_parentid[w2]];
+    bool filterparent = !(m->opt.disableflags & mjDSBL_FILTERPARENT);
+    if (filterparent && w1 && w2 && (w1 == p2 || w2 == p1)) {
+        return false;
+    }
+    int signature = (std::min(b1, b2) << 16) + std::max(b1, b2);
+    for (int e = 0; e < m->nexclude; e++) {
+        if (m->exclude_signature[e] == signature) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// フリージョイント以外の関節をランダムな角度・位置にする
+void sample_joints(const mjModel* m, mjData* d, std::mt19937& rng) {
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    std::normal_distribution<double> normal(0.0, 1.0);
+    mju_copy(d->qpos, m->qpos0, m->nq);
+    for (int j = 0; j < m->njnt; j++) {
+        mjtNum* q = d->qpos + m->jnt_qposadr[j];
+        const mjtNum* range = m->jnt_range + 2 * j;
+        switch (m->jnt_type[j]) {
+        case mjJNT_HINGE:
+            q[0] = m->jnt_limited[j] ? range[0] + (range[1] - range[0]) * unit(rng) : mjPI * (2.0 * unit(rng) - 1.0);
+            break;
+        case mjJNT_SLIDE:
+            if (m->jnt_limited[j]) {
+                q[0] = range[0] + (range[1] - range[0]) * unit(rng);
+            }
+            break;
+        case mjJNT_BALL:
+            for (int i = 0; i < 4; i++) {
+                q[i] = normal(rng);
+            }
+            mju_normalize4(q);
+            break;
+        default:
+            break;
+        }
+    }
+    mj_kinematics(m, d);
+}
+
+}  // namespace
+
+std::vector<GeomPairStat> analyze_geom_pairs(const mjModel* model, const CollisionFilterOptions& options) {
+    std::vector<GeomPairStat> pairs;
+    for (int g1 = 0; g1 < model->ngeom; g1++) {
+        for (int g2 = g1 + 1; g2 < model->ngeom; g2++) {
+            if (is_candidate(model, g1, g2)) {
+                GeomPairStat pair;
+                pair.geom1 = g1;
+                pair.geom2 = g2;
+                pair.min_distance = INFINITY;
+                pairs.push_back(pair);
+            }
+        }
+    }
+
+    // 打ち切り距離は判定距離より十分大きく取る（表示用に距離の目安も残す）
+    const double distmax = std::max(0.1, 10.0 * options.touch_distance);
+    mjData* data = mj_makeData(model);
+    std::mt19937 rng(options.seed);
+    for (int s = 0; s < options.samples && !pairs.empty(); s++) {
+        sample_joints(model, data, rng);
+        for (GeomPairStat& pair : pairs) {
+            double dist = mj_geomDistance(model, data, pair.geom1, pair.geom2, distmax, nullptr);
+            pair.min_distance = std::min(pair.min_distance, dist);
+        }
+    }
+    mj_deleteData(data);
+    return pairs;
+}
+
+std::vector<BodyExclude> propose_excludes(const mjModel* model, const std::vector<GeomPairStat>& pairs,
+                                          double touch_distance) {
+    // ボディ対ごとに集計し、1つでも近づくジオム対があれば除外しない
+    std::map<std::pair<int, int>, BodyExclude> bodies;
+    std::map<std::pair<int, int>, bool> touching;
+    for (const GeomPairStat& pair : pairs) {
+        int b1 = model->geom_bodyid[pair.geom1];
+        int b2 = model->geom_bodyid[pair.geom2];
+        std::pair<int, int> key(std::min(b1, b2), std::max(b1, b2));
+        BodyExclude& exclude = bodies[key];
+        if (exclude.npair == 0) {
+            exclude.min_distance = pair.min_distance;
+        }
+        exclude.npair++;
+        exclude.min_distance = std::min(exclude.min_distance, pair.min_distance);
+        touching[key] = touching[key] || pair.min_distance <= touch_distance;
+    }
+
+    std::vector<BodyExclude> excludes;
+    for (auto& entry : bodies) {
+        if (touching[entry.first]) {
+            continue;
+        }
+        const char* name1 = mj_id2name(model, mjOBJ_BODY, entry.first.first);
+        const char* name2 = mj_id2name(model, mjOBJ_BODY, entry.first.second);
+        if (!name1 || !name2) {
+            std::cerr << "[ERROR] Cannot exclude unnamed bodies " << entry.first.first << " and "
+                      << entry.first.second << std::endl;
+            continue;
+        }
+        entry.second.body1 = name1;
+        entry.second.body2 = name2;
+        excludes.push_back(entry.second);
+    }
+    return excludes;
+}
+
+int apply_excludes(mjSpec* spec, const std::vector<BodyExclude>& excludes) {
+    int count = 0;
+    for (const BodyExclude& exclude : excludes) {
+        mjsExclude* element = mjs_addExclude(spec);
+        if (!element) {
+            std::cerr << "[ERROR] mjs_addExclude failed: " << exclude.body1 << " - " << exclude.body2 << std::endl;
+            continue;
+        }
+        mjs_setString(element->bodyname1, exclude.body1.c_str());
+        mjs_setString(element->bodyname2, exclude.body2.c_str());
+        count++;
+    }
+    return count;
+}
+
+CollisionTiming measure_collision_time(const mjModel* model, int steps) {
+    enable_mujoco_timers();
+    CollisionTiming timing;
+    mjData* data = mj_makeData(model);
+    mj_forward(model, data);
+    std::memset(data->timer, 0, sizeof(data->timer));
+    double ncon = 0;
+    for (int i = 0; i < steps; i++) {
+        for (int u = 0; u < model->nu; u++) {
+            double lo = model->actuator_ctrllimited[u] ? model->actuator_ctrlrange[2 * u] : -1.0;
+            double hi = model->actuator_ctrllimited[u] ? model->actuator_ctrlrange[2 * u + 1] : 1.0;
+            data->ctrl[u] = 0.5 * (lo + hi) + 0.5 * (hi - lo) * std::sin(0.5 * data->time * (u + 1));
+        }
+        mj_step(model, data);
+        ncon += data->ncon;
+    }
+    if (steps > 0) {
+        timing.broad_us = data->timer[mjTIMER_COL_BROAD].duration / steps;
+        timing.narrow_us = data->timer[mjTIMER_COL_NARROW].duration / steps;
+        timing.step_us = data->timer[mjTIMER_STEP].duration / steps;
+        timing.ncon = ncon / steps;
+    }
+    mj_deleteData(data);
+    return timing;
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <mujoco/mujoco.h>
+#include <string>
+#include <vector>
+
+/**
+ * @file mujoco_collision_filter.hpp
+ * @brief 接触し得ないジオム対を見つけて `<exclude>` を生成する解析器
+ *
+ * 同じロボット（ルートボディが同じ）に属するジオム対のうち、MuJoCo の既定のフィルタ
+ * （contype / conaffinity、親子ボディ、既存の exclude）を通過するものを候補とし、
+ * 関節角をランダムにサンプルした姿勢ごとに `mj_geomDistance` で最小距離を求める。
+ * 全サンプルで一定距離より離れたままのボディ対は接触しないものとして exclude を提案し、
+ * mjSpec に `mjs_addExclude` で書き込む。
+ * 異なるロボット同士・ワールド（地面）との対は、配置次第で接触するため対象にしない。
+ */
+
+/**
+ * @brief 解析の設定
+ */
+struct CollisionFilterOptions {
+    int samples = 2000;             ///< サンプルする姿勢の数
+    double touch_distance = 0.01;   ///< これより近づいた対は接触し得るとみなす [m]
+    unsigned int seed = 0;
+};
+
+/**
+ * @brief 候補のジオム対と、サンプル中の最小距離
+ */
+struct GeomPairStat {
+    int geom1 = -1;
+    int geom2 = -1;
+    double min_distance = 0;    ///< 最小距離 [m]（mj_geomDistance の distmax で打ち切った値）
+};
+
+/**
+ * @brief 提案する exclude（ボディ対）
+ */
+struct BodyExclude {
+    std::string body1;
+    std::string body2;
+    int npair = 0;              ///< 含まれる候補のジオム対の数
+    double min_distance = 0;    ///< 含まれるジオム対の最小距離 [m]
+};
+
+/**
+ * @brief ロボット内の候補ジオム対をサンプルし、最小距離を求める
+ * @param model MuJoCoのモデルデータ
+ * @param options 設定
+ * @return 候補のジオム対
+ */
+std::vector<GeomPairStat> analyze_geom_pairs(const mjModel* model,
+                                             const CollisionFilterOptions& options = CollisionFilterOptions());
+
+/**
+ * @brief 全てのジオム対が touch_distance より離れているボディ対を exclude として提案する
+ */
+std::vector<BodyExclude> propose_excludes(const mjModel* model, const std::vector<GeomPairStat>& pairs,
+                                          double touch_distance);
+
+/**
+ * @brief exclude を mjSpec に追加する
+ * @return 追加した数
+ */
+int apply_excludes(mjSpec* spec, const std::vector<BodyExclude>& excludes);
+
+/**
+ * @brief 衝突検出の計測結果（1ステップあたり）
+ */
+struct CollisionTiming {
+    double broad_us = 0;        ///< mjTIMER_COL_BROAD
+    double narrow_us = 0;       ///< mjTIMER_COL_NARROW
+    double step_us = 0;         ///< mjTIMER_STEP
+    double ncon = 0;            ///< 平均接触数
+};
+
+/**
+ * @brief 正弦波の制御入力でシミュレーションし、衝突検出の時間を測る
+ * @param model MuJoCoのモデルデータ
+ * @param steps ステップ数
+ */
+CollisionTiming measure_collision_time(const mjModel* model, int steps);
@@ -1,4 +1,6 @@
 #include "mujoco_debug.hpp"
+#include "mujoco_euler.hpp"
+#include "mujoco_state_view.hpp"
 
 std::string get_joint_type_by_name(const mjModel* model, const std::string& joint_name) {
     int joint_id = mj_name2id(model, mjOBJ_JOINT, joint_name.c_str());
@@ -40,107 +42,101 @@ void print_actuator_range_by_name(const mjModel* model, const std::string& actua
     }
 }
 
+void print_joint_state(const std::string& joint_name, const ConstJointView& joint) {
+    // free / ball 関節は複数要素を持つため jnt_qposadr / jnt_dofadr から切り出した範囲を出力する
+    std::cout << "[Joint] " << joint_name << " | qpos:";
+    for (mjtNum q : joint.qpos()) {
+        std::cout << " " << q;
+    }
+    std::cout << ", qvel:";
+    for (mjtNum v : joint.qvel()) {
+        std::cout << " " << v;
+    }
+    std::cout << std::endl;
+}
+
 void print_joint_state_by_name(const mjModel* model, const mjData* data, const std::string& joint_name) {
-    int joint_id = mj_name2id(model, mjOBJ_JOINT, joint_name.c_str());
-    if (joint_id != -1) {
-        std::cout << "[Joint] " << joint_name 
-                  << " | qpos: " << data->qpos[joint_id]
-                  << ", qvel: " << data->qvel[joint_id] 
-                  << std::endl;
-    } else {
-        std::cerr << "[ERROR] Joint not found: " << joint_name << std::endl;
+    ConstJointView joint = ConstJointView::bind(model, data, joint_name);
+    if (joint.valid()) {
+        print_joint_state(joint_name, joint);
     }
 }
 
+void print_body_state(const std::string& body_name, const ConstBodyView& body) {
+    std::cout << "[Body] " << body_name 
+              << " | Position: (" << body.xpos()[0] << ", "
+                                  << body.xpos()[1] << ", "
+                                  << body.xpos()[2] << ")" 
+              << std::endl;
+}
+
 void print_body_state_by_name(const mjModel* model, const mjData* data, const std::string& body_name) {
-    int body_id = mj_name2id(model, mjOBJ_BODY, body_name.c_str());
-    if (body_id != -1) {
-        std::cout << "[Body] " << body_name 
-                  << " | Position: (" << data->xpos[3 * body_id] << ", "
-                                      << data->xpos[3 * body_id + 1] << ", "
-                                      << data->xpos[3 * body_id + 2] << ")" 
-                  << std::endl;
-    } else {
-        std::cerr << "[ERROR] Body not found: " << body_name << std::endl;
+    ConstBodyView body = ConstBodyView::bind(model, data, body_name);
+    if (body.valid()) {
+        print_body_state(body_name, body);
     }
 }
 
+void print_actuator(const std::string& actuator_name, const ConstActuatorView& actuator) {
+    std::cout << "[Actuator] " << actuator_name 
+              << " | Control Input: " << actuator.ctrl() 
+              << std::endl;
+}
+
 void print_actuator_by_name(const mjModel* model, const mjData* data, const std::string& actuator_name) {
-    int actuator_id = mj_name2id(model, mjOBJ_ACTUATOR, actuator_name.c_str());
-    if (actuator_id != -1) {
-        std::cout << "[Actuator] " << actuator_name 
-                  << " | Control Input: " << data->ctrl[actuator_id] 
-                  << std::endl;
-    } else {
-        std::cerr << "[ERROR] Actuator not found: " << actuator_name << std::endl;
+    ConstActuatorView actuator = ConstActuatorView::bind(model, data, actuator_name);
+    if (actuator.valid()) {
+        print_actuator(actuator_name, actuator);
     }
 }
-void print_hinge_joint_state_deg(const mjModel* model, const mjData* data, const std::string& joint_name) {
-    int joint_id = mj_name2id(model, mjOBJ_JOINT, joint_name.c_str());
-    if (joint_id != -1) {
-        double angle_deg = data->qpos[joint_id] * (180.0 / M_PI);  // ラジアンを度に変換
-        std::cout << "[Hinge Joint] " << joint_name 
-                  << " | Angle (deg): " << angle_deg 
-                  << "° | Angular Velocity (rad/s): " << data->qvel[joint_id] 
-                  << std::endl;
-    } else {
-        std::cerr << "[ERROR] Joint not found: " << joint_name << std::endl;
+
+void print_hinge_joint_state_deg(const std::string& joint_name, const ConstJointView& joint) {
+    if (joint.type() != mjJNT_HINGE) {
+        std::cerr << "[ERROR] Joint is not a hinge: " << joint_name << std::endl;
+        return;
     }
+    double angle_deg = joint.qpos()[0] * (180.0 / M_PI);  // ラジアンを度に変換
+    std::cout << "[Hinge Joint] " << joint_name 
+              << " | Angle (deg): " << angle_deg 
+              << "° | Angular Velocity (rad/s): " << joint.qvel()[0] 
+              << std::endl;
 }
 
-// クォータニオン → オイラー角（ロール・ピッチ・ヨー）の変換関数
-void quat_to_euler(const double* quat, double& roll, double& pitch, double& yaw) {
-    double w = quat[0], x = quat[1], y = quat[2], z = quat[3];
-
-    // Roll (X軸回転)
-    double sinr_cosp = 2 * (w * x + y * z);
-    double cosr_cosp = 1 - 2 * (x * x + y * y);
-    roll = std::atan2(sinr_cosp, cosr_cosp);
-
-    // Pitch (Y軸回転)
-    double sinp = 2 * (w * y - z * x);
-    if (std::abs(sinp) >= 1)
-        pitch = std::copysign(M_PI / 2, sinp);  // 90度 (Gimbal lock)
-    else
-        pitch = std::asin(sinp);
-
-    // Yaw (Z軸回転)
-    double siny_cosp = 2 * (w * z + x * y);
-    double cosy_cosp = 1 - 2 * (y * y + z * z);
-    yaw = std::atan2(siny_cosp, cosy_cosp);
+// ボディの姿勢をラジアンで出力
+void print_body_orientation_rad(const std::string& body_name, const ConstBodyView& body) {
+    double roll, pitch, yaw;
+    quat_to_euler(body.xquat(), roll, pitch, yaw);
+
+    std::cout << "[Body Orientation (rad)] " << body_name 
+              << " | Roll: " << roll
+              << ", Pitch: " << pitch
+              << ", Yaw: " << yaw
+              << std::endl;
 }
 
-// ボディの姿勢をラジアンで出力
 void print_body_orientation_by_name_rad(const mjModel* model, const mjData* data, const std::string& body_name) {
-    int body_id = mj_name2id(model, mjOBJ_BODY, body_name.c_str());
-    if (body_id != -1) {
-        double roll, pitch, yaw;
-        quat_to_euler(&data->xquat[4 * body_id], roll, pitch, yaw);
-        
-        std::cout << "[Body Orientation (rad)] " << body_name 
-                  << " | Roll: " << roll
-                  << ", Pitch: " << pitch
-                  << ", Yaw: " << yaw
-                  << std::endl;
-    } else {
-        std::cerr << "[ERROR] Body not found: " << body_name << std::endl;
+    ConstBodyView body = ConstBodyView::bind(model, data, body_name);
+    if (body.valid()) {
+        print_body_orientation_rad(body_name, body);
     }
 }
 
 // ボディの姿勢を度数法で出力
-void print_body_orientation_by_name_deg(const mjModel* model, const mjData* data, const std::string& body_name) {
-    int body_id = mj_name2id(model, mjOBJ_BODY, body_name.c_str());
-    if (body_id != -1) {
-        double roll, pitch, yaw;
-        quat_to_euler(&data->xquat[4 * body_id], roll, pitch, yaw);
+void print_body_orientation_deg(const std::string& body_name, const ConstBodyView& body) {
+    double roll, pitch, yaw;
+    quat_to_euler(body.xquat(), roll, pitch, yaw);
+
+    std::cout << "[Body Orientation (deg)] " << body_name 
+              << " | Roll: " << roll * (180.0 / M_PI) << "°"
+              << ", Pitch: " << pitch * (180.0 / M_PI) << "°"
+              << ", Yaw: " << yaw * (180.0 / M_PI) << "°"
+              << std::endl;
+}
 
-        std::cout << "[Body Orientation (deg)] " << body_name 
-                  << " | Roll: " << roll * (180.0 / M_PI) << "°"
-                  << ", Pitch: " << pitch * (180.0 / M_PI) << "°"
-                  << ", Yaw: " << yaw * (180.0 / M_PI) << "°"
-                  << std::endl;
-    } else {
-        std::cerr << "[ERROR] Body not found: " << body_name << std::endl;
+void print_body_orientation_by_name_deg(const mjModel* model, const mjData* data, const std::string& body_name) {
+    ConstBodyView body = ConstBodyView::bind(model, data, body_name);
+    if (body.valid()) {
+        print_body_orientation_deg(body_name, body);
     }
 }
 
@@ -150,21 +146,30 @@ void print_all_states(const mjModel* model, const mjData* data) {
     // 基本的な時間情報
     std::cout << "[Time] Simulation Time: " << data->time << " s" << std::endl;
 
-    // 関節の状態
-    print_hinge_joint_state_deg(model, data, "left_wheel_hinge");
-    print_hinge_joint_state_deg(model, data, "right_wheel_hinge");
+    // 関節の状態（名前解決は要素ごとに1回だけ）
+    for (const char* name : {"left_wheel_hinge", "right_wheel_hinge"}) {
+        ConstJointView joint = ConstJointView::bind(model, data, name);
+        if (joint.valid()) {
+            print_hinge_joint_state_deg(name, joint);
+        }
+    }
 
     // 剛体の状態
-    print_body_state_by_name(model, data, "tb3_base");
-    print_body_orientation_by_name_deg(model, data, "tb3_base");
-    print_body_state_by_name(model, data, "left_wheel");
-    print_body_orientation_by_name_deg(model, data, "left_wheel");
-    print_body_state_by_name(model, data, "right_wheel");
-    print_body_orientation_by_name_deg(model, data, "right_wheel");
+    for (const char* name : {"tb3_base", "left_wheel", "right_wheel"}) {
+        ConstBodyView body = ConstBodyView::bind(model, data, name);
+        if (body.valid()) {
+            print_body_state(name, body);
+            print_body_orientation_deg(name, body);
+        }
+    }
 
     // アクチュエータの制御入力
-    print_actuator_by_name(model, data, "left_motor");
-    print_actuator_by_name(model, data, "right_motor");
+    for (const char* name : {"left_motor", "right_motor"}) {
+        ConstActuatorView actuator = ConstActuatorView::bind(model, data, name);
+        if (actuator.valid()) {
+            print_actuator(name, actuator);
+        }
+    }
 
     std::cout << "=======================================" << std::endl;
 }
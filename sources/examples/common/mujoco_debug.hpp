@@ -3,6 +3,7 @@
 #include <mujoco/mujoco.h>
 #include <iostream>
 #include <string>
+#include "mujoco_state_view.hpp"
 
 /**
  * @file mujoco_debug.h
@@ -17,6 +18,9 @@
  * - アクチュエータの制御範囲 (`ctrlrange`)
  * - シミュレーション全体の状態
  *
+ * `*_by_name` は呼ぶたびに名前を解決する。周期的に出力する場合は、ビューを1回だけ束縛して
+ * ビューを受け取る版を呼ぶ。
+ *
  * @author Takashi Mori
  * @date 2025-02-04
  */
@@ -37,6 +41,20 @@ std::string get_joint_type_by_name(const mjModel* model, const std::string& join
  */
 void print_joint_state_by_name(const mjModel* model, const mjData* data, const std::string& joint_name);
 
+/**
+ * @brief 束縛済みの関節ビューの状態を出力する
+ * @param joint_name 表示する関節の名前
+ * @param joint 関節のビュー（valid() であること）
+ */
+void print_joint_state(const std::string& joint_name, const ConstJointView& joint);
+
+/**
+ * @brief 束縛済みのヒンジ関節ビューの角度（度）と角速度を出力する
+ * @param joint_name 表示する関節の名前
+ * @param joint 関節のビュー（valid() であること）
+ */
+void print_hinge_joint_state_deg(const std::string& joint_name, const ConstJointView& joint);
+
 /**
  * @brief 指定した剛体のワールド座標を取得し、出力する
  * @param model MuJoCoのモデルデータ
@@ -45,6 +63,13 @@ void print_joint_state_by_name(const mjModel* model, const mjData* data, const s
  */
 void print_body_state_by_name(const mjModel* model, const mjData* data, const std::string& body_name);
 
+/**
+ * @brief 束縛済みの剛体ビューのワールド座標を出力する
+ * @param body_name 表示するボディの名前
+ * @param body 剛体のビュー（valid() であること）
+ */
+void print_body_state(const std::string& body_name, const ConstBodyView& body);
+
 /**
  * @brief 指定した剛体の慣性情報（質量、慣性テンソル）を取得し、出力する
  * @param model MuJoCoのモデルデータ
@@ -60,6 +85,13 @@ void print_body_inertia_by_name(const mjModel* model, const std::string& body_na
  */
 void print_body_orientation_by_name_rad(const mjModel* model, const mjData* data, const std::string& body_name);
 
+/**
+ * @brief 束縛済みの剛体ビューの姿勢（オイラー角）をラジアンで出力
+ * @param body_name 表示するボディの名前
+ * @param body 剛体のビュー（valid() であること）
+ */
+void print_body_orientation_rad(const std::string& body_name, const ConstBodyView& body);
+
 /**
  * @brief 指定した剛体の姿勢（オイラー角）を取得し、度数法で出力
  * @param model MuJoCoのモデルデータ
@@ -68,6 +100,13 @@ void print_body_orientation_by_name_rad(const mjModel* model, const mjData* data
  */
 void print_body_orientation_by_name_deg(const mjModel* model, const mjData* data, const std::string& body_name);
 
+/**
+ * @brief 束縛済みの剛体ビューの姿勢（オイラー角）を度数法で出力
+ * @param body_name 表示するボディの名前
+ * @param body 剛体のビュー（valid() であること）
+ */
+void print_body_orientation_deg(const std::string& body_name, const ConstBodyView& body);
+
 /**
  * @brief 指定したアクチュエータの制御入力を取得し、出力する
  * @param model MuJoCoのモデルデータ
@@ -76,6 +115,13 @@ void print_body_orientation_by_name_deg(const mjModel* model, const mjData* data
  */
 void print_actuator_by_name(const mjModel* model, const mjData* data, const std::string& actuator_name);
 
+/**
+ * @brief 束縛済みのアクチュエータビューの制御入力を出力する
+ * @param actuator_name 表示するアクチュエータの名前
+ * @param actuator アクチュエータのビュー（valid() であること）
+ */
+void print_actuator(const std::string& actuator_name, const ConstActuatorView& actuator);
+
 /**
  * @brief 指定したアクチュエータの制御範囲 (`ctrlrange`) を取得し、出力する
  * @param model MuJoCoのモデルデータ
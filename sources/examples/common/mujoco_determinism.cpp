@@ -0,0 +1,306 @@
+#include "mujoco_determinism.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <thread>
+#include "mujoco_state_hash.hpp"
+#include "mujoco_thread_pool.hpp"
+
+namespace {
+
+const char kTraceMagic[8] = {'M', 'J', 'T', 'R', 'A', 'C', 'E', '1'};
+
+const char* kStateFieldNames[mjNSTATE] = {
+    "time", "qpos", "qvel", "act", "warmstart", "ctrl", "qfrc_applied",
+    "xfrc_applied", "eq_active", "mocap_pos", "mocap_quat", "userdata", "plugin",
+};
+
+// 1つのシミュレーションを steps ステップ進める
+// - trace: 毎ステップの状態を追加する
+// - reference: 毎ステップ照合し、食い違ったら divergence に書いて停止する
+// - final_state: 最後の状態を書く
+void simulate(const mjModel* model, int64_t steps, const DeterminismConfig& config, unsigned int seed,
+              StateTrace* trace, const StateTrace* reference, Divergence* divergence, mjtNum* final_state) {
+    mjData* data = mj_makeData(model);
+    mjThreadPool* pool = nullptr;
+    if (config.nthread > 0) {
+        pool = mju_threadPoolCreate(config.nthread);
+        mju_bindThreadPool(data, pool);
+    }
+    std::vector<mjtNum> state(mj_stateSize(model, mjSTATE_INTEGRATION));
+
+    // ビューアの代わりに、同じミューテックスを取って状態を読むスレッド
+    std::mutex mutex;
+    std::atomic<bool> done(false);
+    std::thread reader;
+    if (config.pace == PaceMode::Contended) {
+        reader = std::thread([&]() {
+            volatile double sink = 0;
+            while (!done.load(std::memory_order_relaxed)) {
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    for (int i = 0; i < 3 * model->nbody; i++) {
+                        sink = sink + data->xpos[i];
+                    }
+                }
+                std::this_thread::sleep_for(std::chrono::microseconds(200));
+            }
+        });
+    }
+
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int> jitter_us(0, 100);
+    for (int64_t step = 0; step < steps; step++) {
+        {
+            std::unique_lock<std::mutex> lock(mutex, std::defer_lock);
+            if (config.pace == PaceMode::Contended) {
+                lock.lock();
+            }
+            determinism_ctrl(model, step, data->ctrl);
+            mj_step(model, data);
+            if (trace || reference) {
+                mj_getState(model, data, state.data(), mjSTATE_INTEGRATION);
+            }
+        }
+        if (trace) {
+            trace->append(state.data());
+        }
+        if (reference && step < reference->steps()) {
+            int field = reference->compare(step, state.data());
+            if (field >= 0) {
+                divergence->step = step;
+                divergence->field = field;
+                divergence->field_name = reference->field_name(field);
+                break;
+            }
+        }
+        if (config.pace == PaceMode::Jitter && step % 100 == 0) {
+            std::this_thread::sleep_for(std::chrono::microseconds(jitter_us(rng)));
+        }
+    }
+    if (final_state) {
+        mj_getState(model, data, final_state, mjSTATE_INTEGRATION);
+    }
+
+    done = true;
+    if (reader.joinable()) {
+        reader.join();
+    }
+    mj_deleteData(data);
+    if (pool) {
+        mju_threadPoolDestroy(pool);
+    }
+}
+
+}  // namespace
+
+void StateTrace::init(const mjModel* model, int64_t steps) {
+    bits_.clear();
+    sizes_.clear();
+    offsets_.clear();
+    hashes_.clear();
+    int offset = 0;
+    for (int bit = 0; bit < mjNSTATE; bit++) {
+        int size = mj_stateSize(model, 1u << bit);
+        if (size > 0) {
+            bits_.push_back(bit);
+            sizes_.push_back(size);
+            offsets_.push_back(offset);
+        }
+        offset += size;
+    }
+    nfield_ = static_cast<int>(bits_.size());
+    hashes_.reserve(static_cast<size_t>(steps) * nfield_);
+}
+
+void StateTrace::append(const mjtNum* state) {
+    for (int f = 0; f < nfield_; f++) {
+        hashes_.push_back(hash_state(state + offsets_[f], sizes_[f]));
+    }
+}
+
+int StateTrace::compare(int64_t step, const mjtNum* state) const {
+    const uint64_t* expected = hashes_.data() + step * nfield_;
+    for (int f = 0; f < nfield_; f++) {
+        if (hash_state(state + offsets_[f], sizes_[f]) != expected[f]) {
+            return f;
+        }
+    }
+    return -1;
+}
+
+const char* StateTrace::field_name(int field) const {
+    return kStateFieldNames[bits_[field]];
+}
+
+bool StateTrace::save(const std::string& path) const {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        std::cerr << "[ERROR] Failed to open trace file: " << path << std::endl;
+        return false;
+    }
+    int32_t nfield = nfield_;
+    int64_t nstep = steps();
+    out.write(kTraceMagic, sizeof(kTraceMagic));
+    out.write(reinterpret_cast<const char*>(&nfield), sizeof(nfield));
+    out.write(reinterpret_cast<const char*>(&nstep), sizeof(nstep));
+    out.write(reinterpret_cast<const char*>(bits_.data()), sizeof(int) * nfield_);
+    out.write(reinterpret_cast<const char*>(sizes_.data()), sizeof(int) * nfield_);
+    out.write(reinterpret_cast<const char*>(hashes_.data()), sizeof(uint64_t) * hashes_.size());
+    return static_cast<bool>(out);
+}
+
+bool StateTrace::load(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    char magic[8];
+    int32_t nfield = 0;
+    int64_t nstep = 0;
+    if (!in || !in.read(magic, sizeof(magic)) || std::memcmp(magic, kTraceMagic, sizeof(magic)) != 0 ||
+        !in.read(reinterpret_cast<char*>(&nfield), sizeof(nfield)) ||
+        !in.read(reinterpret_cast<char*>(&nstep), sizeof(nstep)) || nfield < 0 || nfield > mjNSTATE) {
+        std::cerr << "[ERROR] Failed to read trace file: " << path << std::endl;
+        return false;
+    }
+    std::vector<int> bits(nfield);
+    std::vector<int> sizes(nfield);
+    in.read(reinterpret_cast<char*>(bits.data()), sizeof(int) * nfield);
+    in.read(reinterpret_cast<char*>(sizes.data()), sizeof(int) * nfield);
+    if (!in) {
+        std::cerr << "[ERROR] Truncated trace file: " << path << std::endl;
+        return false;
+    }
+    // 別のビルドで書かれたファイルでも範囲外を参照しないよう、使う前に確かめる
+    for (int f = 0; f < nfield; f++) {
+        if (bits[f] < 0 || bits[f] >= mjNSTATE || sizes[f] < 0) {
+            std::cerr << "[ERROR] Invalid state field in trace file: " << path << std::endl;
+            return false;
+        }
+    }
+    std::streampos begin = in.tellg();
+    in.seekg(0, std::ios::end);
+    int64_t remaining = static_cast<int64_t>(in.tellg() - begin);
+    in.seekg(begin);
+    if (nstep < 0 || (nfield > 0 && nstep > remaining / static_cast<int64_t>(sizeof(uint64_t) * nfield))) {
+        std::cerr << "[ERROR] Invalid step count in trace file: " << path << " (" << nstep << ")" << std::endl;
+        return false;
+    }
+
+    nfield_ = nfield;
+    bits_.swap(bits);
+    sizes_.swap(sizes);
+    hashes_.resize(static_cast<size_t>(nstep) * nfield_);
+    // 空の要素は保存していないので、保存した要素の大きさを順に足せば状態ベクトル内の位置になる
+    offsets_.assign(nfield_, 0);
+    for (int f = 1; f < nfield_; f++) {
+        offsets_[f] = offsets_[f - 1] + sizes_[f - 1];
+    }
+    in.read(reinterpret_cast<char*>(hashes_.data()), sizeof(uint64_t) * hashes_.size());
+    if (!in) {
+        std::cerr << "[ERROR] Truncated trace file: " << path << std::endl;
+        return false;
+    }
+    return true;
+}
+
+Divergence find_divergence(const StateTrace& reference, const StateTrace& trace) {
+    Divergence result;
+    if (!reference.same_layout(trace)) {
+        result.step = 0;
+        result.field_name = "(state layout)";
+        return result;
+    }
+    int64_t nstep = std::min(reference.steps(), trace.steps());
+    for (int64_t step = 0; step < nstep; step++) {
+        for (int f = 0; f < reference.num_fields(); f++) {
+            if (reference.hash(step, f) != trace.hash(step, f)) {
+                result.step = step;
+                result.field = f;
+                result.field_name = reference.field_name(f);
+                return result;
+            }
+        }
+    }
+    return result;
+}
+
+void determinism_ctrl(const mjModel* model, int64_t step, mjtNum* ctrl) {
+    for (int i = 0; i < model->nu; i++) {
+        double lo = model->actuator_ctrllimited[i] ? model->actuator_ctrlrange[2 * i] : -1.0;
+        double hi = model->actuator_ctrllimited[i] ? model->actuator_ctrlrange[2 * i + 1] : 1.0;
+        double phase = 0.001 * static_cast<double>(step) * (i + 1);
+        ctrl[i] = 0.5 * (lo + hi) + 0.5 * (hi - lo) * std::sin(phase);
+    }
+}
+
+void run_determinism_trace(const mjModel* model, int64_t steps, const DeterminismConfig& config, StateTrace& trace) {
+    trace.init(model, steps);
+    simulate(model, steps, config, 1, &trace, nullptr, nullptr, nullptr);
+}
+
+Divergence run_determinism_check(const mjModel* model, int64_t steps, const DeterminismConfig& config,
+                                 const StateTrace& reference) {
+    StateTrace layout;
+    layout.init(model);
+    if (!reference.same_layout(layout)) {
+        Divergence layout;
+        layout.step = 0;
+        layout.field_name = "(state layout)";
+        return layout;
+    }
+    // レプリカは全て同じ入力・同じ初期状態なので、結果は全て基準と一致するはず
+    int replicas = config.replicas > 0 ? config.replicas : 1;
+    std::vector<Divergence> divergences(replicas);
+    WorkerPool pool(replicas);
+    pool.parallel_for(replicas, [&](int, int begin, int end) {
+        for (int r = begin; r < end; r++) {
+            simulate(model, steps, config, static_cast<unsigned int>(r + 1), nullptr, &reference, &divergences[r],
+                     nullptr);
+        }
+    });
+    Divergence first;
+    for (const Divergence& d : divergences) {
+        if (d.step >= 0 && (first.step < 0 || d.step < first.step)) {
+            first = d;
+        }
+    }
+    return first;
+}
+
+void report_state_difference(const mjModel* model, int64_t step, const DeterminismConfig& reference,
+                             const DeterminismConfig& config) {
+    int size = mj_stateSize(model, mjSTATE_INTEGRATION);
+    std::vector<mjtNum> expected(size), actual(size);
+    // トレースの step 番目は step + 1 回 mj_step した後の状態
+    simulate(model, step + 1, reference, 1, nullptr, nullptr, nullptr, expected.data());
+    simulate(model, step + 1, config, 1, nullptr, nullptr, nullptr, actual.data());
+
+    int offset = 0;
+    int ndiff = 0;
+    for (int bit = 0; bit < mjNSTATE; bit++) {
+        int n = mj_stateSize(model, 1u << bit);
+        for (int i = 0; i < n; i++) {
+            const mjtNum a = expected[offset + i];
+            const mjtNum b = actual[offset + i];
+            if (std::memcmp(&a, &b, sizeof(mjtNum)) != 0) {
+                if (ndiff == 0) {
+                    std::cout << "[Diff] step " << step << " | " << kStateFieldNames[bit] << "[" << i << "]: "
+                              << std::setprecision(17) << a << " vs " << b << std::setprecision(6) << std::endl;
+                }
+                ndiff++;
+            }
+        }
+        offset += n;
+    }
+    if (ndiff == 0) {
+        std::cout << "[Diff] step " << step << " | not reproduced in a single-replica rerun" << std::endl;
+    } else {
+        std::cout << "[Diff] " << ndiff << " differing state elements" << std::endl;
+    }
+}
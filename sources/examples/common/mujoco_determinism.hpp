@@ -0,0 +1,135 @@
+#pragma once
+
+#include <mujoco/mujoco.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @file mujoco_determinism.hpp
+ * @brief スレッド数・ペーシングを変えても物理が変わらないことを確認する検証ハーネス
+ *
+ * 同じモデル・同じ制御入力で毎ステップ `mj_getState(mjSTATE_INTEGRATION)` を取り出し、
+ * 状態の要素（time, qpos, qvel, ...）ごとに64ビットハッシュを記録する（StateTrace）。
+ * 実行条件を変えた2つのトレースを比べれば、最初に食い違ったステップと要素が分かる。
+ * トレースはファイルに保存できるため、ビルドフラグの異なるバイナリ間でも比較できる。
+ */
+
+/**
+ * @brief ペーシングの方法
+ */
+enum class PaceMode {
+    Free,       ///< 待ちなしで進める
+    Jitter,     ///< 一定ステップごとにランダムな時間スリープする（実時間ペーシングの模擬）
+    Contended,  ///< ビューアの代わりのスレッドが同じミューテックスを取り合いながら状態を読む
+};
+
+/**
+ * @brief 実行条件
+ */
+struct DeterminismConfig {
+    std::string label;
+    int nthread = 0;              ///< mjData に束縛する MuJoCo スレッドプールのスレッド数（0 で束縛しない）
+    int replicas = 1;             ///< 同時に走らせる同一シミュレーションの数（WorkerPool で並列実行）
+    PaceMode pace = PaceMode::Free;
+};
+
+/**
+ * @brief 状態要素ごとのハッシュ列
+ */
+class StateTrace {
+public:
+    /**
+     * @brief モデルの状態レイアウトで初期化する（空でない要素だけを対象にする）
+     * @param steps 予定ステップ数（事前確保用）
+     */
+    void init(const mjModel* model, int64_t steps = 0);
+
+    /**
+     * @brief 1ステップぶんの状態（mjSTATE_INTEGRATION）をハッシュして追加する
+     */
+    void append(const mjtNum* state);
+
+    /**
+     * @brief 状態をステップ step の記録と比べる
+     * @return 最初に食い違った要素の番号（一致した場合 -1）
+     */
+    int compare(int64_t step, const mjtNum* state) const;
+
+    int64_t steps() const { return nfield_ ? static_cast<int64_t>(hashes_.size()) / nfield_ : 0; }
+    int num_fields() const { return nfield_; }
+
+    /**
+     * @brief 要素の名前（"qpos" など）
+     */
+    const char* field_name(int field) const;
+
+    /**
+     * @brief ステップ step の要素 field のハッシュ
+     */
+    uint64_t hash(int64_t step, int field) const { return hashes_[step * nfield_ + field]; }
+
+    /**
+     * @brief 要素のレイアウトが同じか
+     */
+    bool same_layout(const StateTrace& other) const { return bits_ == other.bits_ && sizes_ == other.sizes_; }
+
+    bool save(const std::string& path) const;
+    bool load(const std::string& path);
+
+private:
+    int nfield_ = 0;
+    std::vector<int> bits_;     // mjtState のビット番号
+    std::vector<int> sizes_;    // 要素数
+    std::vector<int> offsets_;  // 状態ベクトル内の位置
+    std::vector<uint64_t> hashes_;
+};
+
+/**
+ * @brief 最初の食い違い
+ */
+struct Divergence {
+    int64_t step = -1;  ///< -1 の場合は一致
+    int field = -1;
+    std::string field_name;
+};
+
+/**
+ * @brief 2つのトレースを比較し、最初に食い違ったステップと要素を返す
+ *
+ * ステップ数が異なる場合は短い方の末尾までを比較する。
+ */
+Divergence find_divergence(const StateTrace& reference, const StateTrace& trace);
+
+/**
+ * @brief 決定的な制御入力（ステップ番号の関数、制御範囲内の正弦波）
+ */
+void determinism_ctrl(const mjModel* model, int64_t step, mjtNum* ctrl);
+
+/**
+ * @brief 条件 config で1つのシミュレーションを走らせ、トレースを作る（レプリカ数は無視する）
+ * @param model MuJoCoのモデルデータ
+ * @param steps ステップ数
+ * @param config 実行条件
+ * @param trace 出力
+ */
+void run_determinism_trace(const mjModel* model, int64_t steps, const DeterminismConfig& config, StateTrace& trace);
+
+/**
+ * @brief 条件 config で config.replicas 個のシミュレーションを同時に走らせ、毎ステップ基準トレースと照合する
+ *
+ * トレースは保存せずにその場で比較するため、レプリカ数とステップ数が多くてもメモリを使わない。
+ * 各レプリカは食い違いを見つけた時点で停止する。
+ *
+ * @return 全レプリカのうち最も早い食い違い（一致した場合 step == -1）
+ */
+Divergence run_determinism_check(const mjModel* model, int64_t steps, const DeterminismConfig& config,
+                                 const StateTrace& reference);
+
+/**
+ * @brief 指定ステップまで進め、2つの条件で状態を要素単位で比べて最初の差を出力する
+ *
+ * トレースで食い違いが見つかった後の詳細調査用（同一プロセス内の条件同士のみ）。
+ */
+void report_state_difference(const mjModel* model, int64_t step, const DeterminismConfig& reference,
+                             const DeterminismConfig& config);
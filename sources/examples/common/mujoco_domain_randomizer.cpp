@@ -0,0 +1,163 @@
+#include "mujoco_domain_randomizer.hpp"
+#include <iostream>
+
+static mjtObj target_object(RandomizeTarget target) {
+    switch (target) {
+        case RandomizeTarget::BodyMass:
+        case RandomizeTarget::BodyInertia: return mjOBJ_BODY;
+        case RandomizeTarget::GeomFriction: return mjOBJ_GEOM;
+        case RandomizeTarget::DofDamping: return mjOBJ_JOINT;
+        case RandomizeTarget::ActuatorGear: return mjOBJ_ACTUATOR;
+    }
+    return mjOBJ_UNKNOWN;
+}
+
+static int object_count(const mjModel* m, RandomizeTarget target) {
+    switch (target) {
+        case RandomizeTarget::BodyMass:
+        case RandomizeTarget::BodyInertia: return m->nbody;
+        case RandomizeTarget::GeomFriction: return m->ngeom;
+        case RandomizeTarget::DofDamping: return m->njnt;
+        case RandomizeTarget::ActuatorGear: return m->nu;
+    }
+    return 0;
+}
+
+DomainRandomizer::DomainRandomizer(const mjModel* base, const RandomizeSpec& spec, int nworker, uint64_t seed)
+    : base_(base), valid_(true) {
+    for (const RandomizeEntry& entry : spec) {
+        ResolvedEntry resolved;
+        if (resolve(entry, resolved)) {
+            entries_.push_back(resolved);
+        } else {
+            valid_ = false;
+        }
+    }
+    for (int i = 0; i < nworker; i++) {
+        mjModel* m = mj_copyModel(nullptr, base_);
+        models_.push_back(m);
+        scratch_.push_back(mj_makeData(m));
+        rngs_.emplace_back(seed + i);
+    }
+}
+
+DomainRandomizer::~DomainRandomizer() {
+    for (mjData* d : scratch_) {
+        mj_deleteData(d);
+    }
+    for (mjModel* m : models_) {
+        mj_deleteModel(m);
+    }
+}
+
+bool DomainRandomizer::resolve(const RandomizeEntry& entry, ResolvedEntry& resolved) const {
+    resolved.target = entry.target;
+    resolved.min = entry.min;
+    resolved.max = entry.max;
+    resolved.mode = entry.mode;
+    resolved.ids.clear();
+
+    if (entry.name.empty()) {
+        // ボディ0（world）は対象外
+        int first = target_object(entry.target) == mjOBJ_BODY ? 1 : 0;
+        for (int i = first; i < object_count(base_, entry.target); i++) {
+            resolved.ids.push_back(i);
+        }
+        return check_range(resolved);
+    }
+    int id = mj_name2id(base_, target_object(entry.target), entry.name.c_str());
+    if (id == -1) {
+        std::cerr << "[ERROR] Randomize target not found: " << entry.name << std::endl;
+        return false;
+    }
+    resolved.ids.push_back(id);
+    return check_range(resolved);
+}
+
+bool DomainRandomizer::check_range(const ResolvedEntry& entry) const {
+    if (entry.target != RandomizeTarget::BodyMass && entry.target != RandomizeTarget::BodyInertia) {
+        return true;
+    }
+    // 乱数が min のときが最も小さくなる（Scale は min > 0 なら三角不等式を保つ）
+    const bool add = entry.mode == RandomizeMode::Add;
+    for (int id : entry.ids) {
+        const mjtNum* base = entry.target == RandomizeTarget::BodyMass ? base_->body_mass + id
+                                                                       : base_->body_inertia + 3 * id;
+        int n = entry.target == RandomizeTarget::BodyMass ? 1 : 3;
+        for (int k = 0; k < n; k++) {
+            if (!add && base[k] == 0) {
+                continue;
+            }
+            double value = add ? base[k] + entry.min : base[k] * entry.min;
+            if (value <= 0) {
+                std::cerr << "[ERROR] Randomize range makes body " << id << (n == 1 ? " mass" : " inertia")
+                          << " non-positive (min=" << entry.min << ")" << std::endl;
+                return false;
+            }
+        }
+        // 同じ乱数 s を3成分に加えると、a <= b + c は a <= b + c + s になる
+        if (n == 3 && add) {
+            for (int k = 0; k < 3; k++) {
+                if (base[k] > base[(k + 1) % 3] + base[(k + 2) % 3] + entry.min) {
+                    std::cerr << "[ERROR] Randomize range breaks the inertia triangle inequality of body " << id
+                              << " (min=" << entry.min << ")" << std::endl;
+                    return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+void DomainRandomizer::apply(mjModel* m, const ResolvedEntry& entry, std::mt19937_64& rng) const {
+    std::uniform_real_distribution<double> dist(entry.min, entry.max);
+    auto perturb = [&entry](double base_value, double sample) {
+        return entry.mode == RandomizeMode::Scale ? base_value * sample : base_value + sample;
+    };
+
+    for (int id : entry.ids) {
+        double sample = dist(rng);
+        switch (entry.target) {
+            case RandomizeTarget::BodyMass:
+                m->body_mass[id] = perturb(base_->body_mass[id], sample);
+                break;
+            case RandomizeTarget::BodyInertia:
+                for (int k = 0; k < 3; k++) {
+                    m->body_inertia[3 * id + k] = perturb(base_->body_inertia[3 * id + k], sample);
+                }
+                break;
+            case RandomizeTarget::GeomFriction:
+                m->geom_friction[3 * id] = perturb(base_->geom_friction[3 * id], sample);
+                break;
+            case RandomizeTarget::DofDamping: {
+                // ジョイントに属する全DOF（フリージョイントは6、ボールは3）
+                int nv = base_->jnt_type[id] == mjJNT_FREE ? 6 : base_->jnt_type[id] == mjJNT_BALL ? 3 : 1;
+                int adr = base_->jnt_dofadr[id];
+                for (int k = 0; k < nv; k++) {
+                    m->dof_damping[adr + k] = perturb(base_->dof_damping[adr + k], sample);
+                }
+                break;
+            }
+            case RandomizeTarget::ActuatorGear:
+                // 0 の成分（site の推力以外の方向など）は Add でも変えない
+                for (int k = 0; k < 6; k++) {
+                    double gear = base_->actuator_gear[6 * id + k];
+                    m->actuator_gear[6 * id + k] = gear != 0 ? perturb(gear, sample) : 0;
+                }
+                break;
+        }
+    }
+}
+
+void DomainRandomizer::randomize(int worker) {
+    mjModel* m = models_[worker];
+    for (const ResolvedEntry& entry : entries_) {
+        apply(m, entry, rngs_[worker]);
+    }
+    // 質量・慣性・ギアに依存する派生量（subtreemass, invweight0, acc0 など）を更新する
+    mj_setConst(m, scratch_[worker]);
+}
+
+void DomainRandomizer::restore(int worker) {
+    mj_copyModel(models_[worker], base_);
+}
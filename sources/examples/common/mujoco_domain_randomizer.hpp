@@ -0,0 +1,110 @@
+#pragma once
+
+#include <mujoco/mujoco.h>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+/**
+ * @file mujoco_domain_randomizer.hpp
+ * @brief mjModel のパラメータを再コンパイルせずにランダム化する
+ *
+ * ベースとなる mjModel を1つ保持し、ワーカーごとに `mj_copyModel` した複製を持つ。
+ * randomize() はベースの値を基準に複製のパラメータを上書きし、`mj_setConst` で派生量を再計算する。
+ * XML を再読み込みしないため、1回のランダム化はマイクロ秒単位で終わる。
+ */
+
+/**
+ * @brief ランダム化の対象
+ */
+enum class RandomizeTarget {
+    BodyMass,       ///< body_mass
+    BodyInertia,    ///< body_inertia（3成分を同じ係数で変更）
+    GeomFriction,   ///< geom_friction（滑り摩擦の成分のみ）
+    DofDamping,     ///< dof_damping（name はジョイント名）
+    ActuatorGear,   ///< actuator_gear（6成分を同じ係数で変更）
+};
+
+/**
+ * @brief ベース値への適用方法
+ */
+enum class RandomizeMode {
+    Scale,  ///< ベース値 × 乱数
+    Add,    ///< ベース値 + 乱数
+};
+
+/**
+ * @brief ランダム化の指定1件（乱数は [min, max] の一様分布）
+ *
+ * - BodyMass / BodyInertia: min で質量・慣性が 0 以下になる、または慣性が三角不等式を満たさなくなる
+ *   指定は無効（ベース値が 0 の要素は Scale では 0 のまま）
+ * - ActuatorGear: Add はベース値が 0 でない成分だけに加える（site の推力方向などを変えない）
+ */
+struct RandomizeEntry {
+    RandomizeTarget target;
+    std::string name;                        ///< 対象要素の名前（空の場合はその種類の全要素）
+    double min;
+    double max;
+    RandomizeMode mode = RandomizeMode::Scale;
+};
+
+using RandomizeSpec = std::vector<RandomizeEntry>;
+
+class DomainRandomizer {
+public:
+    /**
+     * @brief ランダム化器を生成する
+     * @param base ベースのモデル（DomainRandomizer より長く生存すること）
+     * @param spec ランダム化の指定
+     * @param nworker モデルの複製数（ワーカー数）
+     * @param seed 乱数の種（ワーカーごとに seed + worker を使う）
+     */
+    DomainRandomizer(const mjModel* base, const RandomizeSpec& spec, int nworker, uint64_t seed = 0);
+    ~DomainRandomizer();
+
+    DomainRandomizer(const DomainRandomizer&) = delete;
+    DomainRandomizer& operator=(const DomainRandomizer&) = delete;
+
+    /**
+     * @brief 指定が正しく解決できたか（名前が見つからない場合 false）
+     */
+    bool valid() const { return valid_; }
+
+    /**
+     * @brief ワーカーのモデル（randomize() で値が変わる）
+     */
+    mjModel* model(int worker) const { return models_[worker]; }
+
+    /**
+     * @brief ワーカーのモデルをランダム化し、派生量を再計算する
+     * @param worker ワーカー番号
+     * @note 同じワーカーのモデルを使う mjData は呼び出し後に mj_forward などで更新すること
+     */
+    void randomize(int worker);
+
+    /**
+     * @brief ワーカーのモデルをベースの値に戻す
+     */
+    void restore(int worker);
+
+private:
+    struct ResolvedEntry {
+        RandomizeTarget target;
+        std::vector<int> ids;
+        double min;
+        double max;
+        RandomizeMode mode;
+    };
+
+    bool resolve(const RandomizeEntry& entry, ResolvedEntry& resolved) const;
+    bool check_range(const ResolvedEntry& entry) const;
+    void apply(mjModel* m, const ResolvedEntry& entry, std::mt19937_64& rng) const;
+
+    const mjModel* base_;
+    bool valid_;
+    std::vector<ResolvedEntry> entries_;
+    std::vector<mjModel*> models_;
+    std::vector<mjData*> scratch_;
+    std::vector<std::mt19937_64> rngs_;
+};
@@ -0,0 +1,141 @@
+#include "mujoco_euler.hpp"
+#include <cmath>
+#if defined(__AVX2__) && defined(__FMA__)
+#include <immintrin.h>
+#endif
+
+void quat_to_euler(const double* quat, double& roll, double& pitch, double& yaw) {
+    double w = quat[0], x = quat[1], y = quat[2], z = quat[3];
+
+    // Roll (X軸回転)
+    double sinr_cosp = 2 * (w * x + y * z);
+    double cosr_cosp = 1 - 2 * (x * x + y * y);
+    roll = std::atan2(sinr_cosp, cosr_cosp);
+
+    // Pitch (Y軸回転)
+    double sinp = 2 * (w * y - z * x);
+    if (std::abs(sinp) >= 1)
+        pitch = std::copysign(M_PI / 2, sinp);  // 90度 (Gimbal lock)
+    else
+        pitch = std::asin(sinp);
+
+    // Yaw (Z軸回転)
+    double siny_cosp = 2 * (w * z + x * y);
+    double cosy_cosp = 1 - 2 * (y * y + z * z);
+    yaw = std::atan2(siny_cosp, cosy_cosp);
+}
+
+#if defined(__AVX2__) && defined(__FMA__)
+
+namespace {
+
+// atan(t), t ∈ [0, 1]
+// Cephes の有理近似: t > 0.66 は atan(t) = π/4 + atan((t-1)/(t+1)) で範囲を縮める
+__m256d atan01_pd(__m256d t) {
+    const __m256d one = _mm256_set1_pd(1.0);
+    __m256d big = _mm256_cmp_pd(t, _mm256_set1_pd(0.66), _CMP_GT_OQ);
+    __m256d reduced = _mm256_div_pd(_mm256_sub_pd(t, one), _mm256_add_pd(t, one));
+    __m256d x = _mm256_blendv_pd(t, reduced, big);
+    __m256d offset = _mm256_and_pd(big, _mm256_set1_pd(M_PI / 4));
+
+    __m256d z = _mm256_mul_pd(x, x);
+    __m256d p = _mm256_set1_pd(-8.750608600031904122785e-1);
+    p = _mm256_fmadd_pd(p, z, _mm256_set1_pd(-1.615753718733365076637e1));
+    p = _mm256_fmadd_pd(p, z, _mm256_set1_pd(-7.500855792314704667340e1));
+    p = _mm256_fmadd_pd(p, z, _mm256_set1_pd(-1.228866684490136173410e2));
+    p = _mm256_fmadd_pd(p, z, _mm256_set1_pd(-6.485021904942025371773e1));
+    __m256d q = _mm256_add_pd(z, _mm256_set1_pd(2.485846490142306297962e1));
+    q = _mm256_fmadd_pd(q, z, _mm256_set1_pd(1.650270098316988542046e2));
+    q = _mm256_fmadd_pd(q, z, _mm256_set1_pd(4.328810604912902668951e2));
+    q = _mm256_fmadd_pd(q, z, _mm256_set1_pd(4.853903996359136964868e2));
+    q = _mm256_fmadd_pd(q, z, _mm256_set1_pd(1.945506571482613964425e2));
+    __m256d r = _mm256_mul_pd(z, _mm256_div_pd(p, q));
+    return _mm256_add_pd(offset, _mm256_fmadd_pd(x, r, x));
+}
+
+// atan2(y, x)（分岐なし、y = x = 0 の場合は 0）
+__m256d atan2_pd(__m256d y, __m256d x) {
+    const __m256d sign_mask = _mm256_set1_pd(-0.0);
+    __m256d ax = _mm256_andnot_pd(sign_mask, x);
+    __m256d ay = _mm256_andnot_pd(sign_mask, y);
+    __m256d num = _mm256_min_pd(ax, ay);
+    __m256d den = _mm256_max_pd(ax, ay);
+    __m256d zero = _mm256_cmp_pd(den, _mm256_setzero_pd(), _CMP_EQ_OQ);
+    __m256d t = _mm256_div_pd(num, _mm256_blendv_pd(den, _mm256_set1_pd(1.0), zero));
+
+    __m256d r = atan01_pd(t);
+    // |y| > |x| なら π/2 - r、x < 0 なら π - r、最後に y の符号を付ける
+    __m256d swap = _mm256_cmp_pd(ay, ax, _CMP_GT_OQ);
+    r = _mm256_blendv_pd(r, _mm256_sub_pd(_mm256_set1_pd(M_PI / 2), r), swap);
+    __m256d neg_x = _mm256_cmp_pd(x, _mm256_setzero_pd(), _CMP_LT_OQ);
+    r = _mm256_blendv_pd(r, _mm256_sub_pd(_mm256_set1_pd(M_PI), r), neg_x);
+    return _mm256_or_pd(r, _mm256_and_pd(sign_mask, y));
+}
+
+// asin(s) = atan2(s, sqrt(1 - s^2))、|s| >= 1 は ±π/2 に丸める
+__m256d asin_clamped_pd(__m256d s) {
+    const __m256d one = _mm256_set1_pd(1.0);
+    s = _mm256_max_pd(_mm256_min_pd(s, one), _mm256_set1_pd(-1.0));
+    __m256d c = _mm256_sqrt_pd(_mm256_fnmadd_pd(s, s, one));
+    return atan2_pd(s, c);
+}
+
+// 4個のクォータニオン（AoS）を w, x, y, z の各レーンへ転置して読む
+inline void load_quat4(const double* q, __m256d& w, __m256d& x, __m256d& y, __m256d& z) {
+    __m256d q0 = _mm256_loadu_pd(q);
+    __m256d q1 = _mm256_loadu_pd(q + 4);
+    __m256d q2 = _mm256_loadu_pd(q + 8);
+    __m256d q3 = _mm256_loadu_pd(q + 12);
+    __m256d t0 = _mm256_unpacklo_pd(q0, q1);  // w0 w1 y0 y1
+    __m256d t1 = _mm256_unpackhi_pd(q0, q1);  // x0 x1 z0 z1
+    __m256d t2 = _mm256_unpacklo_pd(q2, q3);  // w2 w3 y2 y3
+    __m256d t3 = _mm256_unpackhi_pd(q2, q3);  // x2 x3 z2 z3
+    w = _mm256_permute2f128_pd(t0, t2, 0x20);
+    x = _mm256_permute2f128_pd(t1, t3, 0x20);
+    y = _mm256_permute2f128_pd(t0, t2, 0x31);
+    z = _mm256_permute2f128_pd(t1, t3, 0x31);
+}
+
+}  // namespace
+
+void quat_to_euler_batch(const double* quat, int n, double* roll, double* pitch, double* yaw) {
+    const __m256d one = _mm256_set1_pd(1.0);
+    const __m256d two = _mm256_set1_pd(2.0);
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256d w, x, y, z;
+        load_quat4(quat + 4 * i, w, x, y, z);
+
+        __m256d sinr_cosp = _mm256_mul_pd(two, _mm256_fmadd_pd(w, x, _mm256_mul_pd(y, z)));
+        __m256d cosr_cosp = _mm256_fnmadd_pd(two, _mm256_fmadd_pd(x, x, _mm256_mul_pd(y, y)), one);
+        __m256d sinp = _mm256_mul_pd(two, _mm256_fmsub_pd(w, y, _mm256_mul_pd(z, x)));
+        __m256d siny_cosp = _mm256_mul_pd(two, _mm256_fmadd_pd(w, z, _mm256_mul_pd(x, y)));
+        __m256d cosy_cosp = _mm256_fnmadd_pd(two, _mm256_fmadd_pd(y, y, _mm256_mul_pd(z, z)), one);
+
+        _mm256_storeu_pd(roll + i, atan2_pd(sinr_cosp, cosr_cosp));
+        _mm256_storeu_pd(pitch + i, asin_clamped_pd(sinp));
+        _mm256_storeu_pd(yaw + i, atan2_pd(siny_cosp, cosy_cosp));
+    }
+    // 端数はスカラー版で処理する
+    for (; i < n; i++) {
+        quat_to_euler(quat + 4 * i, roll[i], pitch[i], yaw[i]);
+    }
+}
+
+bool quat_to_euler_batch_is_simd() {
+    return true;
+}
+
+#else
+
+void quat_to_euler_batch(const double* quat, int n, double* roll, double* pitch, double* yaw) {
+    for (int i = 0; i < n; i++) {
+        quat_to_euler(quat + 4 * i, roll[i], pitch[i], yaw[i]);
+    }
+}
+
+bool quat_to_euler_batch_is_simd() {
+    return false;
+}
+
+#endif
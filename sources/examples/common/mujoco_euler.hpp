@@ -0,0 +1,40 @@
+#pragma once
+
+#include <mujoco/mujoco.h>
+
+/**
+ * @file mujoco_euler.hpp
+ * @brief クォータニオン → オイラー角（ロール・ピッチ・ヨー）変換
+ *
+ * 1個ずつ変換する `quat_to_euler` と、`xquat[4 * n]` をまとめて SoA 配列
+ * （roll[n], pitch[n], yaw[n]）へ変換するバッチ版を提供する。
+ *
+ * バッチ版は AVX2 と FMA が有効なビルド（`__AVX2__` と `__FMA__` の定義時）では4要素ずつ多項式近似の
+ * atan2 / asin で変換する（スカラー版との差は 1e-13 rad 未満、ただしジンバルロック付近の
+ * ロール・ヨーは元の式自体が不定のため一致しない）。それ以外のビルドでは
+ * `quat_to_euler` を繰り返し呼ぶ。
+ */
+
+/**
+ * @brief クォータニオンをオイラー角に変換する（ZYX順、ラジアン）
+ * @param quat クォータニオン [4] (w, x, y, z)
+ * @param roll X軸回転
+ * @param pitch Y軸回転（特異姿勢では ±π/2）
+ * @param yaw Z軸回転
+ */
+void quat_to_euler(const double* quat, double& roll, double& pitch, double& yaw);
+
+/**
+ * @brief 複数のクォータニオンをまとめてオイラー角に変換する
+ * @param quat クォータニオン配列 [4 * n]（`data->xquat` をそのまま渡せる）
+ * @param n 個数
+ * @param roll 出力 [n]
+ * @param pitch 出力 [n]
+ * @param yaw 出力 [n]
+ */
+void quat_to_euler_batch(const double* quat, int n, double* roll, double* pitch, double* yaw);
+
+/**
+ * @brief バッチ版が AVX2 + FMA で実装されているか
+ */
+bool quat_to_euler_batch_is_simd();
@@ -0,0 +1,168 @@
+#include "mujoco_fleet_builder.hpp"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+namespace {
+
+// body 以下（recurse=true で子孫も）のジオムの contype / conaffinity を書き換える（contype=0 は除く）
+void set_collision_bits(mjsBody* body, bool recurse, int contype, int conaffinity) {
+    for (mjsElement* e = mjs_firstChild(body, mjOBJ_GEOM, recurse); e; e = mjs_nextChild(body, e, recurse)) {
+        mjsGeom* geom = mjs_asGeom(e);
+        if (geom->contype == 0) {  // 自分からは接触を起こさないジオム（見た目用など）は元の設定を保つ
+            continue;
+        }
+        geom->contype = contype;
+        geom->conaffinity = conaffinity;
+    }
+}
+
+mjsBody* first_root_body(mjSpec* spec) {
+    mjsBody* world = mjs_findBody(spec, "world");
+    return world ? mjs_asBody(mjs_firstChild(world, mjOBJ_BODY, 0)) : nullptr;
+}
+
+// アクチュエータが駆動するボディ
+int actuator_body(const mjModel* m, int actuator) {
+    int id = m->actuator_trnid[2 * actuator];
+    switch (m->actuator_trntype[actuator]) {
+    case mjTRN_SITE:
+        return m->site_bodyid[id];
+    case mjTRN_BODY:
+        return id;
+    case mjTRN_JOINT:
+    case mjTRN_JOINTINPARENT:
+        return m->jnt_bodyid[id];
+    default:
+        return -1;
+    }
+}
+
+}  // namespace
+
+FleetBuilder::~FleetBuilder() {
+    if (model_) {
+        mj_deleteModel(model_);
+    }
+    if (spec_) {
+        mj_deleteSpec(spec_);
+    }
+    if (child_) {
+        mj_deleteSpec(child_);
+    }
+}
+
+bool FleetBuilder::build(const std::string& path, const FleetOptions& options) {
+    if (model_) {
+        mj_deleteModel(model_);
+        model_ = nullptr;
+    }
+    if (spec_) {
+        mj_deleteSpec(spec_);
+        spec_ = nullptr;
+    }
+    if (child_) {
+        mj_deleteSpec(child_);
+        child_ = nullptr;
+    }
+    robots_.clear();
+
+    char error[1000];
+    spec_ = mj_parseXML(path.c_str(), nullptr, error, sizeof(error));
+    child_ = spec_ ? mj_parseXML(path.c_str(), nullptr, error, sizeof(error)) : nullptr;
+    if (!spec_ || !child_) {
+        std::cerr << "[ERROR] Failed to parse model: " << path << "\n" << error << std::endl;
+        return false;
+    }
+    mjsBody* robot = first_root_body(spec_);
+    mjsBody* templ = first_root_body(child_);
+    if (!robot || !templ) {
+        std::cerr << "[ERROR] No robot body in " << path << std::endl;
+        return false;
+    }
+
+    if (options.mode == FleetMode::Isolated) {
+        set_collision_bits(mjs_findBody(spec_, "world"), false, kFleetWorldBit, kFleetRobotBit);
+        set_collision_bits(robot, true, kFleetRobotBit, kFleetWorldBit);
+        set_collision_bits(templ, true, kFleetRobotBit, kFleetWorldBit);
+    }
+
+    // **2台目以降を格子状に取り付ける**
+    int columns = options.columns > 0 ? options.columns : static_cast<int>(std::ceil(std::sqrt(options.robots)));
+    columns = std::max(columns, 1);
+    mjsBody* world = mjs_findBody(spec_, "world");
+    for (int k = 1; k < options.robots; k++) {
+        mjsFrame* frame = mjs_addFrame(world, nullptr);
+        frame->pos[0] = options.spacing * (k % columns);
+        frame->pos[1] = options.spacing * (k / columns);
+        std::string prefix = "robot" + std::to_string(k) + "_";
+        if (!mjs_attachBody(frame, templ, prefix.c_str(), "")) {
+            std::cerr << "[ERROR] mjs_attachBody failed for robot " << k << ": " << mjs_getError(spec_) << std::endl;
+            return false;
+        }
+    }
+
+    model_ = mj_compile(spec_, nullptr);
+    if (!model_) {
+        std::cerr << "[ERROR] Failed to compile fleet: " << mjs_getError(spec_) << std::endl;
+        return false;
+    }
+
+    root_name_ = mjs_getString(robot->name);
+    robots_.resize(options.robots);
+    for (int k = 0; k < options.robots; k++) {
+        robots_[k].prefix = k == 0 ? "" : "robot" + std::to_string(k) + "_";
+    }
+    return make_handles();
+}
+
+bool FleetBuilder::make_handles() {
+    for (RobotHandle& h : robots_) {
+        h.root_body = mj_name2id(model_, mjOBJ_BODY, (h.prefix + root_name_).c_str());
+        if (h.root_body < 0) {
+            std::cerr << "[ERROR] Robot body not found: " << h.prefix + root_name_ << std::endl;
+            return false;
+        }
+
+        // 取り付けた部分木の関節・アクチュエータは連続して並ぶので、先頭と数で表す
+        int qmin = model_->nq, vmin = model_->nv, umin = model_->nu;
+        h.nq = h.nv = h.nu = 0;
+        for (int j = 0; j < model_->njnt; j++) {
+            if (model_->body_rootid[model_->jnt_bodyid[j]] != h.root_body) {
+                continue;
+            }
+            int nq = j + 1 < model_->njnt ? model_->jnt_qposadr[j + 1] - model_->jnt_qposadr[j]
+                                          : model_->nq - model_->jnt_qposadr[j];
+            int nv = j + 1 < model_->njnt ? model_->jnt_dofadr[j + 1] - model_->jnt_dofadr[j]
+                                          : model_->nv - model_->jnt_dofadr[j];
+            qmin = std::min(qmin, model_->jnt_qposadr[j]);
+            vmin = std::min(vmin, model_->jnt_dofadr[j]);
+            h.nq += nq;
+            h.nv += nv;
+        }
+        for (int u = 0; u < model_->nu; u++) {
+            int body = actuator_body(model_, u);
+            if (body >= 0 && model_->body_rootid[body] == h.root_body) {
+                umin = std::min(umin, u);
+                h.nu++;
+            }
+        }
+        h.qposadr = h.nq ? qmin : 0;
+        h.dofadr = h.nv ? vmin : 0;
+        h.ctrladr = h.nu ? umin : 0;
+
+        // 連続していることを確認する（ctrl スライスとして使うため）
+        for (int u = h.ctrladr; u < h.ctrladr + h.nu; u++) {
+            int body = actuator_body(model_, u);
+            if (body < 0 || model_->body_rootid[body] != h.root_body) {
+                std::cerr << "[ERROR] Actuators of robot '" << h.prefix << "' are not contiguous" << std::endl;
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+int FleetBuilder::id(mjtObj type, int index, const std::string& name) const {
+    return mj_name2id(model_, type, (robots_[index].prefix + name).c_str());
+}
@@ -0,0 +1,315 @@
+#include "mujoco_ilqr.hpp"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <utility>
+
+// 正則化係数の範囲
+static const mjtNum kMuMin = 1e-6;
+static const mjtNum kMuMax = 1e10;
+
+IlqrSolver::IlqrSolver(const mjModel* model, const IlqrOptions& options, const IlqrCost& cost)
+    : model_(model),
+      options_(options),
+      cost_(cost),
+      nx_(2 * model->nv + model->na),
+      nu_(model->nu),
+      nstate_(mj_stateSize(model, mjSTATE_INTEGRATION)),
+      pool_(options.nworker),
+      state0_(nstate_),
+      candidates_(std::max(1, options.nline_search)),
+      cost_value_(0) {
+    const int T = options_.horizon;
+    for (int i = 0; i < pool_.size(); i++) {
+        worker_data_.push_back(mj_makeData(model_));
+        worker_scratch_.emplace_back(nx_);
+    }
+    resize(nominal_);
+    for (Trajectory& traj : candidates_) {
+        resize(traj);
+    }
+    A_.resize(T * nx_ * nx_);
+    B_.resize(T * nx_ * nu_);
+    k_.resize(T * nu_);
+    K_.resize(T * nu_ * nx_);
+}
+
+IlqrSolver::~IlqrSolver() {
+    for (mjData* d : worker_data_) {
+        mj_deleteData(d);
+    }
+}
+
+void IlqrSolver::resize(Trajectory& traj) const {
+    const int T = options_.horizon;
+    traj.state.resize((T + 1) * nstate_);
+    traj.qpos.resize((T + 1) * model_->nq);
+    traj.qvel.resize((T + 1) * model_->nv);
+    traj.act.resize((T + 1) * model_->na);
+    traj.U.resize(T * nu_);
+}
+
+void IlqrSolver::set_goal(const mjtNum* goal_qpos) {
+    cost_.goal_qpos.assign(goal_qpos, goal_qpos + model_->nq);
+}
+
+void IlqrSolver::shift(std::vector<mjtNum>& U) const {
+    const int T = options_.horizon;
+    if (T < 2) {
+        return;
+    }
+    for (int t = 0; t < T - 1; t++) {
+        mju_copy(U.data() + t * nu_, U.data() + (t + 1) * nu_, nu_);
+    }
+}
+
+void IlqrSolver::state_error(const mjtNum* qpos, const mjtNum* qvel, const mjtNum* act,
+                             const mjtNum* qpos_ref, const mjtNum* qvel_ref, const mjtNum* act_ref,
+                             mjtNum* dx) const {
+    const int nv = model_->nv;
+    const int na = model_->na;
+    mj_differentiatePos(model_, dx, 1.0, qpos_ref, qpos);
+    for (int i = 0; i < nv; i++) {
+        dx[nv + i] = qvel[i] - (qvel_ref ? qvel_ref[i] : 0);
+    }
+    for (int i = 0; i < na; i++) {
+        dx[2 * nv + i] = act[i] - (act_ref ? act_ref[i] : 0);
+    }
+}
+
+mjtNum IlqrSolver::knot_cost(const mjtNum* dx, const mjtNum* u, bool terminal) const {
+    const std::vector<mjtNum>& Q = terminal ? cost_.Qf : cost_.Q;
+    mjtNum cost = 0;
+    for (int i = 0; i < nx_; i++) {
+        cost += 0.5 * Q[i] * dx[i] * dx[i];
+    }
+    if (!terminal) {
+        for (int i = 0; i < nu_; i++) {
+            mjtNum du = u[i] - cost_.u_ref[i];
+            cost += 0.5 * cost_.R[i] * du * du;
+        }
+    }
+    return cost;
+}
+
+void IlqrSolver::rollout(int worker, const mjtNum* state0, mjtNum alpha, Trajectory& traj) {
+    const int T = options_.horizon;
+    const int nq = model_->nq;
+    const int nv = model_->nv;
+    const int na = model_->na;
+    mjData* d = worker_data_[worker];
+    mjtNum* dx = worker_scratch_[worker].data();
+
+    mj_setState(model_, d, state0, mjSTATE_INTEGRATION);
+    traj.cost = 0;
+    for (int t = 0; t <= T; t++) {
+        mjtNum* u = traj.U.data() + t * nu_;
+        if (t < T) {
+            // alpha >= 0 のときは前回の軌道まわりのフィードバック付きで入力を更新する
+            if (alpha >= 0) {
+                state_error(d->qpos, d->qvel, d->act,
+                            nominal_.qpos.data() + t * nq, nominal_.qvel.data() + t * nv,
+                            nominal_.act.data() + t * na, dx);
+                const mjtNum* K = K_.data() + t * nu_ * nx_;
+                for (int i = 0; i < nu_; i++) {
+                    u[i] = nominal_.U[t * nu_ + i] + alpha * k_[t * nu_ + i] + mju_dot(K + i * nx_, dx, nx_);
+                }
+            }
+            for (int i = 0; i < nu_; i++) {
+                if (model_->actuator_ctrllimited[i]) {
+                    u[i] = mju_clip(u[i], model_->actuator_ctrlrange[2 * i], model_->actuator_ctrlrange[2 * i + 1]);
+                }
+            }
+            mju_copy(d->ctrl, u, nu_);
+        }
+
+        mj_getState(model_, d, traj.state.data() + t * nstate_, mjSTATE_INTEGRATION);
+        mju_copy(traj.qpos.data() + t * nq, d->qpos, nq);
+        mju_copy(traj.qvel.data() + t * nv, d->qvel, nv);
+        mju_copy(traj.act.data() + t * na, d->act, na);
+
+        state_error(d->qpos, d->qvel, d->act, cost_.goal_qpos.data(), nullptr, nullptr, dx);
+        traj.cost += knot_cost(dx, u, t == T);
+
+        if (t < T) {
+            mj_step(model_, d);
+        }
+    }
+}
+
+void IlqrSolver::compute_derivatives() {
+    pool_.parallel_for(options_.horizon, [this](int worker, int begin, int end) {
+        mjData* d = worker_data_[worker];
+        for (int t = begin; t < end; t++) {
+            mj_setState(model_, d, nominal_.state.data() + t * nstate_, mjSTATE_INTEGRATION);
+            mjd_transitionFD(model_, d, options_.fd_eps, 0,
+                             A_.data() + t * nx_ * nx_, B_.data() + t * nx_ * nu_, nullptr, nullptr);
+        }
+    });
+}
+
+bool IlqrSolver::backward_pass(mjtNum mu) {
+    const int T = options_.horizon;
+    const int nq = model_->nq;
+    const int nv = model_->nv;
+    const int na = model_->na;
+    std::vector<mjtNum> dx(nx_), Vx(nx_), Vxx(nx_ * nx_);
+    std::vector<mjtNum> Qx(nx_), Qu(nu_), Qxx(nx_ * nx_), Quu(nu_ * nu_), Quu_factor(nu_ * nu_), Qux(nu_ * nx_);
+    std::vector<mjtNum> VxxA(nx_ * nx_), VxxB(nx_ * nu_), tmp(nx_ * nx_), rhs(nu_), sol(nu_);
+    std::vector<mjtNum> Quu_k(nu_), Quu_K(nu_ * nx_);
+
+    // 終端コスト
+    state_error(nominal_.qpos.data() + T * nq, nominal_.qvel.data() + T * nv, nominal_.act.data() + T * na,
+                cost_.goal_qpos.data(), nullptr, nullptr, dx.data());
+    mju_zero(Vxx.data(), nx_ * nx_);
+    for (int i = 0; i < nx_; i++) {
+        Vx[i] = cost_.Qf[i] * dx[i];
+        Vxx[i * nx_ + i] = cost_.Qf[i];
+    }
+
+    for (int t = T - 1; t >= 0; t--) {
+        const mjtNum* A = A_.data() + t * nx_ * nx_;
+        const mjtNum* B = B_.data() + t * nx_ * nu_;
+        const mjtNum* u = nominal_.U.data() + t * nu_;
+        mjtNum* k = k_.data() + t * nu_;
+        mjtNum* K = K_.data() + t * nu_ * nx_;
+        state_error(nominal_.qpos.data() + t * nq, nominal_.qvel.data() + t * nv, nominal_.act.data() + t * na,
+                    cost_.goal_qpos.data(), nullptr, nullptr, dx.data());
+
+        // Q関数の一次・二次の係数
+        mju_mulMatTVec(Qx.data(), A, Vx.data(), nx_, nx_);
+        mju_mulMatTVec(Qu.data(), B, Vx.data(), nx_, nu_);
+        for (int i = 0; i < nx_; i++) {
+            Qx[i] += cost_.Q[i] * dx[i];
+        }
+        for (int i = 0; i < nu_; i++) {
+            Qu[i] += cost_.R[i] * (u[i] - cost_.u_ref[i]);
+        }
+        mju_mulMatMat(VxxA.data(), Vxx.data(), A, nx_, nx_, nx_);
+        mju_mulMatMat(VxxB.data(), Vxx.data(), B, nx_, nx_, nu_);
+        mju_mulMatTMat(Qxx.data(), A, VxxA.data(), nx_, nx_, nx_);
+        mju_mulMatTMat(Quu.data(), B, VxxB.data(), nx_, nu_, nu_);
+        mju_mulMatTMat(Qux.data(), B, VxxA.data(), nx_, nu_, nx_);
+        for (int i = 0; i < nx_; i++) {
+            Qxx[i * nx_ + i] += cost_.Q[i];
+        }
+        for (int i = 0; i < nu_; i++) {
+            Quu[i * nu_ + i] += cost_.R[i];
+        }
+
+        // k = -Quu^-1 Qu, K = -Quu^-1 Qux（Quu は正則化して分解）
+        mju_copy(Quu_factor.data(), Quu.data(), nu_ * nu_);
+        for (int i = 0; i < nu_; i++) {
+            Quu_factor[i * nu_ + i] += mu;
+        }
+        if (mju_cholFactor(Quu_factor.data(), nu_, mjMINVAL) != nu_) {
+            return false;
+        }
+        mju_cholSolve(k, Quu_factor.data(), Qu.data(), nu_);
+        mju_scl(k, k, -1, nu_);
+        for (int c = 0; c < nx_; c++) {
+            for (int r = 0; r < nu_; r++) {
+                rhs[r] = Qux[r * nx_ + c];
+            }
+            mju_cholSolve(sol.data(), Quu_factor.data(), rhs.data(), nu_);
+            for (int r = 0; r < nu_; r++) {
+                K[r * nx_ + c] = -sol[r];
+            }
+        }
+
+        // Vx = Qx + K' Quu k + K' Qu + Qux' k
+        mju_mulMatVec(Quu_k.data(), Quu.data(), k, nu_, nu_);
+        mju_copy(Vx.data(), Qx.data(), nx_);
+        for (int i = 0; i < nx_; i++) {
+            for (int r = 0; r < nu_; r++) {
+                Vx[i] += K[r * nx_ + i] * (Quu_k[r] + Qu[r]) + Qux[r * nx_ + i] * k[r];
+            }
+        }
+
+        // Vxx = Qxx + K' Quu K + K' Qux + Qux' K
+        mju_mulMatMat(Quu_K.data(), Quu.data(), K, nu_, nu_, nx_);
+        mju_copy(Vxx.data(), Qxx.data(), nx_ * nx_);
+        mju_mulMatTMat(tmp.data(), K, Quu_K.data(), nu_, nx_, nx_);
+        mju_addTo(Vxx.data(), tmp.data(), nx_ * nx_);
+        mju_mulMatTMat(tmp.data(), K, Qux.data(), nu_, nx_, nx_);
+        mju_addTo(Vxx.data(), tmp.data(), nx_ * nx_);
+        mju_mulMatTMat(tmp.data(), Qux.data(), K, nu_, nx_, nx_);
+        mju_addTo(Vxx.data(), tmp.data(), nx_ * nx_);
+        mju_symmetrize(Vxx.data(), Vxx.data(), nx_);
+    }
+    return true;
+}
+
+int IlqrSolver::solve(const mjData* data, std::vector<mjtNum>& U, int max_iter) {
+    const int T = options_.horizon;
+    if (max_iter <= 0) {
+        max_iter = options_.max_iter;
+    }
+    if (static_cast<int>(U.size()) != T * nu_) {
+        // 初期推定値がない場合は基準入力で埋める
+        U.resize(T * nu_);
+        for (int t = 0; t < T; t++) {
+            mju_copy(U.data() + t * nu_, cost_.u_ref.data(), nu_);
+        }
+    }
+
+    mj_getState(model_, data, state0_.data(), mjSTATE_INTEGRATION);
+    mju_copy(nominal_.U.data(), U.data(), T * nu_);
+    rollout(0, state0_.data(), -1, nominal_);
+
+    const int ncandidate = static_cast<int>(candidates_.size());
+    mjtNum mu = kMuMin;
+    int iter = 0;
+    bool need_derivatives = true;
+    while (iter < max_iter) {
+        iter++;
+        if (need_derivatives) {
+            compute_derivatives();
+        }
+        while (!backward_pass(mu)) {
+            mu = std::fmax(mu * 10, kMuMin);
+            if (mu > kMuMax) {
+                std::cerr << "[ERROR] iLQR: backward pass failed (regularization limit)" << std::endl;
+                break;
+            }
+        }
+        if (mu > kMuMax) {
+            break;
+        }
+
+        // ステップ幅 1, 1/2, 1/4, ... の候補を並列にロールアウトする
+        pool_.parallel_for(ncandidate, [this](int worker, int begin, int end) {
+            for (int c = begin; c < end; c++) {
+                rollout(worker, state0_.data(), std::ldexp(1.0, -c), candidates_[c]);
+            }
+        });
+        int best = -1;
+        for (int c = 0; c < ncandidate; c++) {
+            if (candidates_[c].cost < nominal_.cost && (best == -1 || candidates_[c].cost < candidates_[best].cost)) {
+                best = c;
+            }
+        }
+
+        if (best == -1) {
+            // 改善しない場合は正則化を強めて同じ微分でやり直す
+            need_derivatives = false;
+            mu = std::fmax(mu * 10, kMuMin);
+            if (mu > kMuMax) {
+                break;
+            }
+            continue;
+        }
+
+        mjtNum improvement = (nominal_.cost - candidates_[best].cost) / std::fmax(nominal_.cost, mjMINVAL);
+        std::swap(nominal_, candidates_[best]);
+        need_derivatives = true;
+        mu = std::fmax(mu / 10, kMuMin);
+        if (improvement < options_.tol) {
+            break;
+        }
+    }
+
+    mju_copy(U.data(), nominal_.U.data(), T * nu_);
+    cost_value_ = nominal_.cost;
+    return iter;
+}
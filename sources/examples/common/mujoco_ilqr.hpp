@@ -0,0 +1,124 @@
+#pragma once
+
+#include <mujoco/mujoco.h>
+#include <vector>
+#include "mujoco_thread_pool.hpp"
+
+/**
+ * @file mujoco_ilqr.hpp
+ * @brief iLQR による制御入力系列の最適化
+ *
+ * - ダイナミクスの微分は各ノットで `mjd_transitionFD` を使い、ノット単位でワーカーに分割して並列に求める
+ * - 前進パスの直線探索は複数のステップ幅をワーカーに分割して並列に評価する
+ * - 各ワーカーは専用の `mjData` を持つ
+ *
+ * 状態偏差は `mjd_transitionFD` と同じ接空間の定義 [qpos 差分 (nv), qvel (nv), act (na)] を使う。
+ */
+
+/**
+ * @brief 二次コスト（対角重み）
+ *
+ * 走行コスト: 0.5 * dx' Q dx + 0.5 * (u - u_ref)' R (u - u_ref)
+ * 終端コスト: 0.5 * dx' Qf dx
+ * dx は目標状態（goal_qpos, 速度0, act 0）からの偏差
+ */
+struct IlqrCost {
+    std::vector<mjtNum> Q;          ///< 走行コストの状態重み (nx)
+    std::vector<mjtNum> R;          ///< 入力重み (nu)
+    std::vector<mjtNum> Qf;         ///< 終端コストの状態重み (nx)
+    std::vector<mjtNum> goal_qpos;  ///< 目標位置 (nq)
+    std::vector<mjtNum> u_ref;      ///< 基準入力 (nu)
+};
+
+/**
+ * @brief iLQR の設定
+ */
+struct IlqrOptions {
+    int horizon = 100;              ///< ノット数（ステップ数）
+    int max_iter = 50;              ///< 最大反復回数
+    mjtNum tol = 1e-4;              ///< コストの相対改善量がこれを下回ったら終了
+    int nworker = 1;                ///< ワーカー数
+    int nline_search = 8;           ///< 直線探索で並列評価するステップ幅の数（1, 1/2, 1/4, ...）
+    mjtNum fd_eps = 1e-6;           ///< 有限差分の摂動幅
+};
+
+class IlqrSolver {
+public:
+    /**
+     * @brief ソルバを生成する
+     * @param model MuJoCoのモデルデータ（IlqrSolver より長く生存すること）
+     * @param options 設定
+     * @param cost コスト
+     */
+    IlqrSolver(const mjModel* model, const IlqrOptions& options, const IlqrCost& cost);
+    ~IlqrSolver();
+
+    IlqrSolver(const IlqrSolver&) = delete;
+    IlqrSolver& operator=(const IlqrSolver&) = delete;
+
+    /**
+     * @brief data の状態を初期状態として制御入力系列を最適化する
+     * @param data 初期状態（変更しない）
+     * @param U 制御入力系列 (horizon x nu, 行優先)。初期推定値を渡し、最適化結果で上書きされる
+     * @param max_iter 最大反復回数（0以下の場合は options の値）
+     * @return 実行した反復回数
+     */
+    int solve(const mjData* data, std::vector<mjtNum>& U, int max_iter = 0);
+
+    /**
+     * @brief 後退ホライズン制御用に制御入力系列を1ステップ進める（末尾は最後の入力を複製）
+     * @param U 制御入力系列 (horizon x nu)
+     */
+    void shift(std::vector<mjtNum>& U) const;
+
+    /**
+     * @brief cost の目標状態を変更する
+     */
+    void set_goal(const mjtNum* goal_qpos);
+
+    mjtNum cost() const { return cost_value_; }
+    int horizon() const { return options_.horizon; }
+
+    /**
+     * @brief 最適化後の位置の軌道 ((horizon + 1) x nq)
+     */
+    const std::vector<mjtNum>& qpos_trajectory() const { return nominal_.qpos; }
+
+private:
+    struct Trajectory {
+        std::vector<mjtNum> state;   // (T+1) x nstate
+        std::vector<mjtNum> qpos;    // (T+1) x nq
+        std::vector<mjtNum> qvel;    // (T+1) x nv
+        std::vector<mjtNum> act;     // (T+1) x na
+        std::vector<mjtNum> U;       // T x nu
+        mjtNum cost = 0;
+    };
+
+    void resize(Trajectory& traj) const;
+    void rollout(int worker, const mjtNum* state0, mjtNum alpha, Trajectory& traj);
+    void state_error(const mjtNum* qpos, const mjtNum* qvel, const mjtNum* act,
+                     const mjtNum* qpos_ref, const mjtNum* qvel_ref, const mjtNum* act_ref, mjtNum* dx) const;
+    mjtNum knot_cost(const mjtNum* dx, const mjtNum* u, bool terminal) const;
+    void compute_derivatives();
+    bool backward_pass(mjtNum mu);
+
+    const mjModel* model_;
+    IlqrOptions options_;
+    IlqrCost cost_;
+    int nx_;
+    int nu_;
+    int nstate_;
+
+    WorkerPool pool_;
+    std::vector<mjData*> worker_data_;
+    std::vector<std::vector<mjtNum>> worker_scratch_;
+
+    std::vector<mjtNum> state0_;
+    Trajectory nominal_;
+    std::vector<Trajectory> candidates_;
+    std::vector<mjtNum> A_;   // T x nx x nx
+    std::vector<mjtNum> B_;   // T x nx x nu
+    std::vector<mjtNum> k_;   // T x nu
+    std::vector<mjtNum> K_;   // T x nu x nx
+    mjtNum cost_value_;
+};
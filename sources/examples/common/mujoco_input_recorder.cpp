@@ -0,0 +1,303 @@
+#include "mujoco_input_recorder.hpp"
+#include <cstring>
+#include <iostream>
+
+namespace {
+
+const char kMagic[8] = {'M', 'J', 'I', 'N', 'P', 'U', 'T', '1'};
+
+template <typename T>
+bool read_value(std::ifstream& in, T& value) {
+    return static_cast<bool>(in.read(reinterpret_cast<char*>(&value), sizeof(T)));
+}
+
+bool read_array(std::ifstream& in, mjtNum* values, int n) {
+    return static_cast<bool>(in.read(reinterpret_cast<char*>(values), sizeof(mjtNum) * n));
+}
+
+bool all_zero(const mjtNum* values, int n) {
+    for (int i = 0; i < n; i++) {
+        if (values[i] != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+}  // namespace
+
+InputRecorder::InputRecorder(const mjModel* model, int checkpoint_interval)
+    : model_(model),
+      checkpoint_interval_(checkpoint_interval > 0 ? checkpoint_interval : 1),
+      hasher_(model, mjSTATE_INTEGRATION),
+      step_(0),
+      timestep_(model->opt.timestep) {}
+
+InputRecorder::~InputRecorder() {
+    if (out_.is_open()) {
+        out_.close();
+    }
+}
+
+bool InputRecorder::open(const std::string& path) {
+    out_.open(path, std::ios::binary | std::ios::trunc);
+    if (!out_) {
+        std::cerr << "[ERROR] Failed to open record file: " << path << std::endl;
+        return false;
+    }
+    InputLogHeader header = {};
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.nq = model_->nq;
+    header.nv = model_->nv;
+    header.nu = model_->nu;
+    header.nbody = model_->nbody;
+    header.state_size = static_cast<int32_t>(hasher_.state().size());
+    header.checkpoint_interval = checkpoint_interval_;
+    header.timestep = model_->opt.timestep;
+    out_.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    step_ = 0;
+    timestep_ = header.timestep;
+    return true;
+}
+
+void InputRecorder::write_checkpoint(const mjData* data, char tag) {
+    uint64_t hash = hasher_.hash(data);
+    const std::vector<mjtNum>& state = hasher_.state();
+    out_.put(tag);
+    out_.write(reinterpret_cast<const char*>(&step_), sizeof(step_));
+    out_.write(reinterpret_cast<const char*>(&hash), sizeof(hash));
+    out_.write(reinterpret_cast<const char*>(state.data()), sizeof(mjtNum) * state.size());
+}
+
+void InputRecorder::record(const mjData* data) {
+    if (!out_.is_open()) {
+        return;
+    }
+    if (step_ % checkpoint_interval_ == 0) {
+        write_checkpoint(data, 'C');
+    }
+    // 外力が無いステップは ctrl だけを書く
+    const int nxfrc = 6 * model_->nbody;
+    bool has_xfrc = !all_zero(data->xfrc_applied, nxfrc);
+    out_.put(has_xfrc ? 'X' : 'U');
+    out_.write(reinterpret_cast<const char*>(data->ctrl), sizeof(mjtNum) * model_->nu);
+    if (has_xfrc) {
+        out_.write(reinterpret_cast<const char*>(data->xfrc_applied), sizeof(mjtNum) * nxfrc);
+    }
+    step_++;
+}
+
+void InputRecorder::record_timestep(double timestep) {
+    if (!out_.is_open() || step_ == 0 || timestep == timestep_) {
+        return;
+    }
+    out_.put('D');
+    out_.write(reinterpret_cast<const char*>(&timestep), sizeof(timestep));
+    timestep_ = timestep;
+}
+
+void InputRecorder::record_rewind(const mjData* data) {
+    if (!out_.is_open()) {
+        return;
+    }
+    write_checkpoint(data, 'R');
+}
+
+void InputRecorder::close(const mjData* data) {
+    if (!out_.is_open()) {
+        return;
+    }
+    write_checkpoint(data, 'C');
+    out_.close();
+}
+
+bool InputReplay::load(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        std::cerr << "[ERROR] Failed to open record file: " << path << std::endl;
+        return false;
+    }
+    if (!read_value(in, header_) || std::memcmp(header_.magic, kMagic, sizeof(kMagic)) != 0) {
+        std::cerr << "[ERROR] Not an input record file: " << path << std::endl;
+        return false;
+    }
+
+    steps_ = 0;
+    checkpoints_.clear();
+    states_.clear();
+    ctrl_.clear();
+    xfrc_index_.clear();
+    xfrc_.clear();
+    timesteps_.clear();
+    double timestep = header_.timestep;
+
+    const int nu = header_.nu;
+    const int nxfrc = 6 * header_.nbody;
+    char tag;
+    while (in.get(tag)) {
+        bool ok = true;
+        if (tag == 'C' || tag == 'R') {
+            Checkpoint checkpoint;
+            checkpoint.offset = states_.size();
+            checkpoint.rewind = tag == 'R';
+            states_.resize(states_.size() + header_.state_size);
+            ok = read_value(in, checkpoint.step) && read_value(in, checkpoint.hash) &&
+                 read_array(in, states_.data() + checkpoint.offset, header_.state_size);
+            if (ok && checkpoint.step != steps_) {
+                std::cerr << "[ERROR] Checkpoint step mismatch: " << checkpoint.step << " (expected " << steps_ << ")"
+                          << std::endl;
+                return false;
+            }
+            checkpoints_.push_back(checkpoint);
+        } else if (tag == 'U' || tag == 'X') {
+            ctrl_.resize(ctrl_.size() + nu);
+            ok = read_array(in, ctrl_.data() + ctrl_.size() - nu, nu);
+            if (tag == 'X') {
+                xfrc_index_.push_back(static_cast<int64_t>(xfrc_.size()));
+                xfrc_.resize(xfrc_.size() + nxfrc);
+                ok = ok && read_array(in, xfrc_.data() + xfrc_.size() - nxfrc, nxfrc);
+            } else {
+                xfrc_index_.push_back(-1);
+            }
+            timesteps_.push_back(timestep);
+            steps_++;
+        } else if (tag == 'D') {
+            ok = read_value(in, timestep) && !timesteps_.empty();
+            if (ok) {
+                timesteps_.back() = timestep;
+            }
+        } else {
+            ok = false;
+        }
+        if (!ok) {
+            // 記録中に終了した場合など、末尾の壊れたレコードは捨てる
+            std::cerr << "[ERROR] Truncated or corrupt record at step " << steps_ << ", ignoring the rest" << std::endl;
+            if (tag == 'C' || tag == 'R') {
+                checkpoints_.pop_back();
+            }
+            break;
+        }
+    }
+    if (checkpoints_.empty()) {
+        std::cerr << "[ERROR] No checkpoint in record file: " << path << std::endl;
+        return false;
+    }
+    variable_timestep_ = false;
+    duration_ = 0;
+    for (double dt : timesteps_) {
+        variable_timestep_ = variable_timestep_ || dt != header_.timestep;
+        duration_ += dt;
+    }
+    // 最後のチェックポイントより後の入力は状態の照合ができないが、再生には使える
+    return true;
+}
+
+bool InputReplay::compatible(const mjModel* model) const {
+    return header_.nq == model->nq && header_.nv == model->nv && header_.nu == model->nu &&
+           header_.nbody == model->nbody && header_.state_size == mj_stateSize(model, mjSTATE_INTEGRATION) &&
+           header_.timestep == model->opt.timestep;
+}
+
+const InputReplay::Checkpoint* InputReplay::checkpoint_at(int64_t step) const {
+    const Checkpoint* found = nullptr;
+    for (const Checkpoint& checkpoint : checkpoints_) {
+        if (checkpoint.step > step) {
+            break;
+        }
+        found = &checkpoint;
+    }
+    return found;
+}
+
+bool InputReplay::initial_state(const mjModel* model, mjData* data) const {
+    if (checkpoints_.empty() || header_.nu != model->nu || header_.nbody != model->nbody ||
+        header_.state_size != mj_stateSize(model, mjSTATE_INTEGRATION)) {
+        std::cerr << "[ERROR] Model does not match the record" << std::endl;
+        return false;
+    }
+    mj_setState(model, data, states_.data() + checkpoints_.front().offset, mjSTATE_INTEGRATION);
+    mj_forward(model, data);
+    return true;
+}
+
+void InputReplay::apply_input(const mjModel* model, mjData* data, int64_t step) const {
+    mju_copy(data->ctrl, ctrl_.data() + step * model->nu, model->nu);
+    int64_t index = xfrc_index_[step];
+    if (index >= 0) {
+        mju_copy(data->xfrc_applied, xfrc_.data() + index, 6 * model->nbody);
+    } else {
+        mju_zero(data->xfrc_applied, 6 * model->nbody);
+    }
+}
+
+bool InputReplay::simulate(const mjModel* model, mjData* data, int64_t begin, int64_t end, const ReplayStepFn& fn) {
+    mismatch_step_ = -1;
+    if (!compatible(model)) {
+        std::cerr << "[ERROR] Model does not match the record" << std::endl;
+        return false;
+    }
+    if (begin < 0 || end > steps_ || begin > end) {
+        std::cerr << "[ERROR] Invalid replay range: [" << begin << ", " << end << "] (steps=" << steps_ << ")"
+                  << std::endl;
+        return false;
+    }
+
+    // 可変 timestep の場合は、opt.timestep を書き換えるための複製で進める
+    mjModel* variable = variable_timestep_ ? mj_copyModel(nullptr, model) : nullptr;
+    const mjModel* stepping = variable ? variable : model;
+
+    const Checkpoint* start = checkpoint_at(begin);
+    mj_setState(model, data, states_.data() + start->offset, mjSTATE_INTEGRATION);
+    bool ok = true;
+
+    StateHasher hasher(model, mjSTATE_INTEGRATION);
+    std::vector<mjtNum> warmstart(model->nv);
+    size_t next_checkpoint = static_cast<size_t>(start - checkpoints_.data());
+    for (int64_t step = start->step;; step++) {
+        // 巻き戻しの記録は、記録時と同じく入力を与える前に状態を置き換える
+        while (next_checkpoint < checkpoints_.size() && checkpoints_[next_checkpoint].step == step &&
+               checkpoints_[next_checkpoint].rewind) {
+            mj_setState(model, data, states_.data() + checkpoints_[next_checkpoint].offset, mjSTATE_INTEGRATION);
+            next_checkpoint++;
+        }
+        if (step < steps_) {
+            apply_input(model, data, step);
+        }
+        // チェックポイントは入力を設定した状態で記録されている
+        if (next_checkpoint < checkpoints_.size() && checkpoints_[next_checkpoint].step == step) {
+            if (hasher.hash(data) != checkpoints_[next_checkpoint].hash) {
+                std::cerr << "[ERROR] Replay diverged at checkpoint step " << step << std::endl;
+                mismatch_step_ = step;
+                ok = false;
+                break;
+            }
+            next_checkpoint++;
+        }
+        if (step >= begin && fn) {
+            // 位置などの派生量を更新してから渡す。mj_forward は qacc_warmstart（状態の一部）を書き換えるため、
+            // 次の mj_step が記録時と同じ初期値から解くよう元に戻す
+            mju_copy(warmstart.data(), data->qacc_warmstart, model->nv);
+            mj_forward(model, data);
+            fn(step, data);
+            mju_copy(data->qacc_warmstart, warmstart.data(), model->nv);
+        }
+        if (step >= end) {
+            break;
+        }
+        if (variable) {
+            variable->opt.timestep = timesteps_[step];
+        }
+        mj_step(stepping, data);
+    }
+    if (variable) {
+        mj_deleteModel(variable);
+    }
+    return ok;
+}
+
+int64_t InputReplay::verify(const mjModel* model, mjData* data) {
+    if (simulate(model, data, 0, steps_, nullptr)) {
+        return -1;
+    }
+    return mismatch_step_ >= 0 ? mismatch_step_ : 0;
+}
@@ -0,0 +1,223 @@
+#pragma once
+
+#include <mujoco/mujoco.h>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <string>
+#include <vector>
+#include "mujoco_state_hash.hpp"
+
+/**
+ * @file mujoco_input_recorder.hpp
+ * @brief 入力のみの記録と決定的な再シミュレーション
+ *
+ * 全状態を毎ステップ保存する代わりに、初期状態・毎ステップの入力（`ctrl` と `xfrc_applied`）・
+ * 一定間隔のチェックポイント（状態とハッシュ）だけをバイナリファイルに記録する。
+ * 再生側は指定区間の直前のチェックポイントから入力を与えて mj_step し直すことで、
+ * 任意の区間の状態を再構成する。途中のチェックポイントではハッシュを照合し、
+ * 再シミュレーションがビット単位で一致しているかを確認する。
+ *
+ * ファイル形式（ネイティブエンディアン）:
+ * - ヘッダ（InputLogHeader）
+ * - レコードの列（先頭1バイトが種類）
+ *   - 'C': チェックポイント  int64 step, uint64 hash, mjtNum state[state_size]
+ *   - 'R': 状態の置き換え    'C' と同じ形式。巻き戻しなどで状態が不連続に変わったことを表し、
+ *                            再生時はハッシュを照合せず、ステップ step の入力を与える前にこの状態に置き換える
+ *   - 'U': 入力              mjtNum ctrl[nu]（xfrc_applied は全て0）
+ *   - 'X': 入力              mjtNum ctrl[nu], mjtNum xfrc_applied[6 * nbody]
+ *   - 'D': timestep          double timestep（直前の入力のステップとそれ以降に適用する。
+ *                            可変 timestep の場合に、値が変わったステップでのみ書く。無ければ header.timestep）
+ *
+ * @note 決定性は同じモデル・同じ MuJoCo ビルドで再生する場合のみ保証される。
+ *       ctrl / xfrc_applied 以外の入力（qfrc_applied, mocap など）は記録しない。
+ */
+
+/**
+ * @brief 記録ファイルのヘッダ
+ */
+struct InputLogHeader {
+    char magic[8];            ///< "MJINPUT1"
+    int32_t nq;
+    int32_t nv;
+    int32_t nu;
+    int32_t nbody;
+    int32_t state_size;       ///< mj_stateSize(model, mjSTATE_INTEGRATION)
+    int32_t checkpoint_interval;
+    double timestep;          ///< 最初のステップの timestep
+};
+
+/**
+ * @brief 入力の記録
+ */
+class InputRecorder {
+public:
+    /**
+     * @param model MuJoCoのモデルデータ
+     * @param checkpoint_interval チェックポイントを書くステップ間隔
+     */
+    InputRecorder(const mjModel* model, int checkpoint_interval = 10000);
+    ~InputRecorder();
+
+    InputRecorder(const InputRecorder&) = delete;
+    InputRecorder& operator=(const InputRecorder&) = delete;
+
+    /**
+     * @brief 記録ファイルを開き、ヘッダを書く
+     * @return 成功した場合 true
+     */
+    bool open(const std::string& path);
+
+    /**
+     * @brief 1ステップぶんの入力を記録する（mj_step の直前、ctrl などを設定した後に呼ぶ）
+     *
+     * ステップ番号がチェックポイント間隔の倍数の場合は、先に現在の状態をチェックポイントとして書く。
+     * 最初の呼び出しで書かれるチェックポイントが初期状態になる。
+     */
+    void record(const mjData* data);
+
+    /**
+     * @brief 直前に record() したステップで実際に使った timestep を記録する
+     *
+     * 可変 timestep（AdaptiveStepper や StepWatchdog の回復中）の場合に mj_step の後に呼ぶ。
+     * 前のステップと同じ値なら何も書かない。
+     */
+    void record_timestep(double timestep);
+
+    /**
+     * @brief 状態が不連続に変わったこと（StepWatchdog の巻き戻しなど）を記録する
+     *
+     * 直前に record() したステップの結果を捨て、data の状態から続けたことを表す 'R' レコードを書く。
+     * 状態を変えた後、次の record() の前に呼ぶ。
+     */
+    void record_rewind(const mjData* data);
+
+    /**
+     * @brief 最後の状態をチェックポイントとして書いてファイルを閉じる
+     */
+    void close(const mjData* data);
+
+    /**
+     * @brief 記録したステップ数
+     */
+    int64_t steps() const { return step_; }
+
+private:
+    void write_checkpoint(const mjData* data, char tag);
+
+    const mjModel* model_;
+    int checkpoint_interval_;
+    StateHasher hasher_;
+    std::ofstream out_;
+    int64_t step_;
+    double timestep_;         // 最後に記録した timestep
+};
+
+/**
+ * @brief 再シミュレーション中に各ステップの状態を受け取る関数
+ * @param step ステップ番号（data はこのステップの状態で、ctrl / xfrc_applied はこのステップの入力）
+ */
+using ReplayStepFn = std::function<void(int64_t step, const mjData* data)>;
+
+/**
+ * @brief 記録ファイルからの再シミュレーション
+ */
+class InputReplay {
+public:
+    /**
+     * @brief 記録ファイルを読み込む
+     * @return 成功した場合 true
+     */
+    bool load(const std::string& path);
+
+    /**
+     * @brief モデルが記録時と同じ構成か（次元と最初の timestep を確認）
+     */
+    bool compatible(const mjModel* model) const;
+
+    /**
+     * @brief ステップ step の timestep
+     */
+    double timestep(int64_t step) const { return timesteps_[step]; }
+
+    /**
+     * @brief timestep が途中で変わる記録か
+     */
+    bool variable_timestep() const { return variable_timestep_; }
+
+    /**
+     * @brief 記録全体のシミュレーション時間 [s]
+     */
+    double duration() const { return duration_; }
+
+    /**
+     * @brief 記録されたステップ数
+     */
+    int64_t steps() const { return steps_; }
+
+    /**
+     * @brief チェックポイント数
+     */
+    int num_checkpoints() const { return static_cast<int>(checkpoints_.size()); }
+
+    const InputLogHeader& header() const { return header_; }
+
+    /**
+     * @brief 区間 [begin, end] の状態を再構成する
+     *
+     * begin 以前で最も近いチェックポイントから状態を復元して進め、begin〜end の各ステップで fn を呼ぶ。
+     * 途中で通過したチェックポイントのハッシュが一致しない場合はエラーを出力して false を返す。
+     * 可変 timestep の記録では、モデルの複製の opt.timestep をステップごとに書き換えて進める。
+     *
+     * @param model 記録時と同じモデル
+     * @param data 作業用のシミュレーションデータ（上書きされる）
+     * @param begin 開始ステップ
+     * @param end 終了ステップ（steps() 以下）
+     * @param fn 各ステップで呼ぶ関数（nullptr 可）
+     * @return 再構成できハッシュも一致した場合 true
+     */
+    bool simulate(const mjModel* model, mjData* data, int64_t begin, int64_t end, const ReplayStepFn& fn);
+
+    /**
+     * @brief 記録全体を再シミュレーションし、全チェックポイントのハッシュを照合する
+     * @return 全て一致した場合 -1、それ以外は最初に一致しなかったチェックポイントのステップ番号
+     */
+    int64_t verify(const mjModel* model, mjData* data);
+
+    /**
+     * @brief 記録の初期状態を設定する
+     *
+     * ソルバ設定などを変えたモデルで入力だけを開ループで与え直す場合に使う（ハッシュは照合しない）。
+     * 以降は各ステップで apply_input() してから mj_step する。
+     *
+     * @return 次元が一致し初期状態を設定できた場合 true
+     */
+    bool initial_state(const mjModel* model, mjData* data) const;
+
+    /**
+     * @brief ステップ step の入力（ctrl / xfrc_applied）を設定する（timestep は timestep(step) で取得する）
+     */
+    void apply_input(const mjModel* model, mjData* data, int64_t step) const;
+
+private:
+    struct Checkpoint {
+        int64_t step;
+        uint64_t hash;
+        size_t offset;  // states_ 内の位置
+        bool rewind;    // 'R'（照合せずに状態を置き換える）
+    };
+
+    const Checkpoint* checkpoint_at(int64_t step) const;
+
+    InputLogHeader header_ = {};
+    int64_t steps_ = 0;
+    std::vector<Checkpoint> checkpoints_;
+    std::vector<mjtNum> states_;
+    std::vector<mjtNum> ctrl_;          // [steps x nu]
+    std::vector<int64_t> xfrc_index_;   // ステップごとの xfrc_ 内の位置（なければ -1）
+    std::vector<mjtNum> xfrc_;
+    std::vector<double> timesteps_;     // ステップごとの timestep
+    bool variable_timestep_ = false;
+    double duration_ = 0;
+    int64_t mismatch_step_ = -1;
+};
@@ -0,0 +1,190 @@
+#include "mujoco_integrator_sweep.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+
+namespace {
+
+// sample_period が timestep の整数倍なら1サンプルあたりのステップ数、そうでなければ 0
+int64_t steps_per_sample(double sample_period, double timestep) {
+    int64_t n = std::llround(sample_period / timestep);
+    if (n < 1 || std::fabs(n * timestep - sample_period) > 1e-9 * sample_period) {
+        return 0;
+    }
+    return n;
+}
+
+bool diverged(const mjData* data, const mjtNum* xpos, int n) {
+    if (data->warning[mjWARN_BADQACC].number > 0 || data->warning[mjWARN_BADQVEL].number > 0 ||
+        data->warning[mjWARN_BADQPOS].number > 0) {
+        return true;
+    }
+    for (int i = 0; i < n; i++) {
+        if (!std::isfinite(xpos[i])) {
+            return true;
+        }
+    }
+    return false;
+}
+
+}  // namespace
+
+const char* integrator_name(int integrator) {
+    switch (integrator) {
+    case mjINT_EULER:
+        return "Euler";
+    case mjINT_RK4:
+        return "RK4";
+    case mjINT_IMPLICIT:
+        return "implicit";
+    case mjINT_IMPLICITFAST:
+        return "implicitfast";
+    default:
+        return "unknown";
+    }
+}
+
+bool record_trajectory(const mjModel* model, const SweepCtrlFn& ctrl, const SweepOptions& options,
+                       std::vector<mjtNum>& samples, double* ns_per_step) {
+    int64_t per_sample = steps_per_sample(options.sample_period, model->opt.timestep);
+    if (per_sample == 0) {
+        std::cerr << "[ERROR] Sample period " << options.sample_period << " is not a multiple of timestep "
+                  << model->opt.timestep << std::endl;
+        return false;
+    }
+    int64_t nsample = static_cast<int64_t>(options.duration / options.sample_period);
+    int width = 3 * model->nbody;
+    samples.assign(static_cast<size_t>(nsample) * width, 0);
+
+    mjData* data = mj_makeData(model);
+    mj_forward(model, data);
+    bool stable = true;
+    auto start = std::chrono::steady_clock::now();
+    for (int64_t s = 0; s < nsample && stable; s++) {
+        for (int64_t i = 0; i < per_sample; i++) {
+            if (ctrl) {
+                ctrl(model, data, data->ctrl);
+            }
+            mj_step(model, data);
+        }
+        std::copy(data->xpos, data->xpos + width, samples.begin() + s * width);
+        stable = !diverged(data, data->xpos, width);
+    }
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    if (ns_per_step) {
+        *ns_per_step = elapsed.count() / static_cast<double>(nsample * per_sample);
+    }
+    mj_deleteData(data);
+    return stable;
+}
+
+std::vector<SweepResult> run_integrator_sweep(const mjModel* model, const std::vector<int>& integrators,
+                                              const std::vector<double>& timesteps, const SweepCtrlFn& ctrl,
+                                              const SweepOptions& options) {
+    std::vector<SweepResult> results;
+    mjModel* m = mj_copyModel(nullptr, model);
+
+    // **基準軌道**
+    std::vector<mjtNum> reference;
+    m->opt.integrator = options.reference_integrator;
+    m->opt.timestep = options.reference_timestep;
+    if (!record_trajectory(m, ctrl, options, reference, nullptr)) {
+        std::cerr << "[ERROR] Reference trajectory diverged" << std::endl;
+        mj_deleteModel(m);
+        return results;
+    }
+
+    // **組み合わせごとの計測**
+    std::vector<mjtNum> samples;
+    for (int integrator : integrators) {
+        for (double timestep : timesteps) {
+            if (steps_per_sample(options.sample_period, timestep) == 0) {
+                std::cerr << "[ERROR] Skipping timestep " << timestep << " (sample period "
+                          << options.sample_period << " is not a multiple)" << std::endl;
+                continue;
+            }
+            m->opt.integrator = integrator;
+            m->opt.timestep = timestep;
+
+            SweepResult result;
+            result.integrator = integrator;
+            result.timestep = timestep;
+            result.ns_per_step = 1e300;
+            for (int r = 0; r < std::max(options.repeats, 1); r++) {
+                double ns = 0;
+                result.stable = record_trajectory(m, ctrl, options, samples, &ns);
+                result.ns_per_step = std::min(result.ns_per_step, ns);
+                if (!result.stable) {
+                    break;
+                }
+            }
+            result.ns_per_second = result.ns_per_step / timestep;
+
+            if (result.stable) {
+                for (size_t i = 0; i < samples.size(); i++) {
+                    result.max_error = std::max(result.max_error, std::fabs(samples[i] - reference[i]));
+                }
+            } else {
+                result.max_error = INFINITY;
+            }
+            results.push_back(result);
+        }
+    }
+    mj_deleteModel(m);
+
+    // **パレート最適: コストと誤差の両方で他に負けない組み合わせ**
+    for (SweepResult& a : results) {
+        a.pareto = a.stable;
+        for (const SweepResult& b : results) {
+            if (&a == &b || !b.stable) {
+                continue;
+            }
+            bool no_worse = b.ns_per_second <= a.ns_per_second && b.max_error <= a.max_error;
+            bool better = b.ns_per_second < a.ns_per_second || b.max_error < a.max_error;
+            if (no_worse && better) {
+                a.pareto = false;
+                break;
+            }
+        }
+    }
+    return results;
+}
+
+const SweepResult* cheapest_within(const std::vector<SweepResult>& results, double max_error) {
+    const SweepResult* best = nullptr;
+    for (const SweepResult& r : results) {
+        if (r.stable && r.max_error <= max_error && (!best || r.ns_per_second < best->ns_per_second)) {
+            best = &r;
+        }
+    }
+    return best;
+}
+
+void print_sweep_table(const std::vector<SweepResult>& results, std::ostream& out) {
+    std::vector<const SweepResult*> sorted;
+    for (const SweepResult& r : results) {
+        sorted.push_back(&r);
+    }
+    std::sort(sorted.begin(), sorted.end(), [](const SweepResult* a, const SweepResult* b) {
+        return a->ns_per_second < b->ns_per_second;
+    });
+
+    out << std::left << std::setw(14) << "integrator" << std::right << std::setw(10) << "timestep"
+        << std::setw(12) << "ns/step" << std::setw(14) << "us/sim-sec" << std::setw(14) << "max err [m]"
+        << "  pareto" << std::endl;
+    for (const SweepResult* r : sorted) {
+        out << std::left << std::setw(14) << integrator_name(r->integrator) << std::right << std::setw(10)
+            << r->timestep << std::fixed << std::setprecision(1) << std::setw(12) << r->ns_per_step
+            << std::setw(14) << r->ns_per_second / 1000.0 << std::defaultfloat << std::setprecision(6);
+        if (r->stable) {
+            out << std::setw(14) << std::setprecision(3) << std::scientific << r->max_error << std::defaultfloat
+                << std::setprecision(6);
+        } else {
+            out << std::setw(14) << "diverged";
+        }
+        out << (r->pareto ? "  *" : "") << std::endl;
+    }
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <mujoco/mujoco.h>
+#include <functional>
+#include <ostream>
+#include <vector>
+
+/**
+ * @file mujoco_integrator_sweep.hpp
+ * @brief 積分器と timestep の組み合わせごとのコストと精度を測る
+ *
+ * 各組み合わせで同じ制御入力のまま一定時間シミュレーションし、
+ * 1ステップあたりの時間と、細かい timestep で求めた基準軌道からの誤差を測る。
+ * 誤差は一定のシミュレーション時刻ごとに全ボディのワールド位置 (xpos) を比べた最大値 [m] とする。
+ * 最後に「より速く、かつより正確な組み合わせが他に無い」ものをパレート最適として印を付ける。
+ */
+
+/**
+ * @brief 制御入力の計算（data->time などから ctrl を書く。毎ステップ mj_step の前に呼ぶ）
+ */
+using SweepCtrlFn = std::function<void(const mjModel* model, const mjData* data, mjtNum* ctrl)>;
+
+/**
+ * @brief スイープの設定
+ */
+struct SweepOptions {
+    double duration = 5.0;                     ///< シミュレーション時間 [s]
+    double sample_period = 0.04;               ///< 誤差を比べる間隔 [s]（各 timestep の整数倍にする）
+    int reference_integrator = mjINT_RK4;      ///< 基準軌道の積分器
+    double reference_timestep = 0.0005;        ///< 基準軌道の timestep [s]
+    int repeats = 3;                           ///< 計測の繰り返し回数（最速の値を採用する）
+};
+
+/**
+ * @brief 1つの組み合わせの結果
+ */
+struct SweepResult {
+    int integrator = mjINT_EULER;
+    double timestep = 0;
+    double ns_per_step = 0;      ///< 1ステップあたりの時間
+    double ns_per_second = 0;    ///< シミュレーション1秒あたりの時間（timestep の違いを含めたコスト）
+    double max_error = 0;        ///< 基準軌道からの最大位置誤差 [m]
+    bool stable = true;          ///< 発散（NaN / 警告による初期化）しなかったか
+    bool pareto = false;         ///< パレート最適か
+};
+
+/**
+ * @brief 一定時間シミュレーションし、sample_period ごとの全ボディの xpos を記録する
+ * @param model MuJoCoのモデルデータ（opt.integrator / opt.timestep を設定済みのもの）
+ * @param ctrl 制御入力
+ * @param options 設定
+ * @param samples 出力（サンプル数 x nbody x 3）
+ * @param ns_per_step 出力（1ステップあたりの時間、不要なら nullptr）
+ * @return 発散しなかった場合 true
+ */
+bool record_trajectory(const mjModel* model, const SweepCtrlFn& ctrl, const SweepOptions& options,
+                       std::vector<mjtNum>& samples, double* ns_per_step);
+
+/**
+ * @brief 積分器と timestep の全組み合わせを計測する
+ * @param model MuJoCoのモデルデータ（変更しない）
+ * @param integrators 積分器（mjINT_*）
+ * @param timesteps timestep [s]
+ * @param ctrl 制御入力
+ * @param options 設定
+ * @return 組み合わせごとの結果（pareto 設定済み）、基準軌道が作れなかった場合は空
+ */
+std::vector<SweepResult> run_integrator_sweep(const mjModel* model, const std::vector<int>& integrators,
+                                              const std::vector<double>& timesteps, const SweepCtrlFn& ctrl,
+                                              const SweepOptions& options = SweepOptions());
+
+/**
+ * @brief 積分器の名前（MJCF の integrator 属性と同じ表記）
+ */
+const char* integrator_name(int integrator);
+
+/**
+ * @brief 精度の上限を満たす中で最もコスト (ns_per_second) の低い組み合わせ
+ * @return 見つからない場合 nullptr
+ */
+const SweepResult* cheapest_within(const std::vector<SweepResult>& results, double max_error);
+
+/**
+ * @brief 結果をコスト順の表として出力する
+ */
+void print_sweep_table(const std::vector<SweepResult>& results, std::ostream& out);
@@ -0,0 +1,57 @@
+#include "mujoco_island_stats.hpp"
+#include <algorithm>
+#include <iomanip>
+#include "mujoco_thread_pool.hpp"
+
+bool configure_island_stepping(mjModel* model, mjData* data, IslandStepMode mode, const WorkerPool* pool) {
+    if (mode == IslandStepMode::Off) {
+        model->opt.enableflags &= ~mjENBL_ISLAND;
+    } else {
+        model->opt.enableflags |= mjENBL_ISLAND;
+    }
+    mjThreadPool* handle = mode == IslandStepMode::Parallel && pool ? pool->handle() : nullptr;
+    mju_bindThreadPool(data, handle);
+    return mode != IslandStepMode::Parallel || handle != nullptr;
+}
+
+const char* island_step_mode_name(IslandStepMode mode) {
+    switch (mode) {
+    case IslandStepMode::Off:
+        return "off";
+    case IslandStepMode::Serial:
+        return "serial";
+    case IslandStepMode::Parallel:
+        return "parallel";
+    }
+    return "?";
+}
+
+void IslandMonitor::record(const mjData* data) {
+    steps_++;
+    islands_ += data->nisland;
+    solver_islands_ += data->solver_nisland;
+    efcs_ += data->nefc;
+    max_islands_ = std::max(max_islands_, data->nisland);
+    for (int i = 0; i < data->nisland; i++) {
+        int dofs = data->island_dofnum[i];
+        int efcs = data->island_efcnum[i];
+        island_efcs_ += efcs;
+        max_dofs_ = std::max(max_dofs_, dofs);
+        max_efcs_ = std::max(max_efcs_, efcs);
+        dof_histogram_[dofs]++;
+    }
+}
+
+void IslandMonitor::print(std::ostream& out) const {
+    out << "[INFO] islands: steps=" << steps_ << std::fixed << std::setprecision(2)
+        << " mean=" << mean_islands() << " max=" << max_islands_ << " solver_mean=" << mean_solver_islands()
+        << " largest(dof=" << max_dofs_ << " efc=" << max_efcs_ << ")";
+    if (efcs_ > 0) {
+        out << " efc_in_islands=" << 100.0 * island_efcs_ / efcs_ << "%";
+    }
+    out << std::endl;
+    for (const auto& bin : dof_histogram_) {
+        out << "  dof=" << std::setw(4) << bin.first << "  islands/step=" << std::setprecision(2)
+            << static_cast<double>(bin.second) / std::max(steps_, 1LL) << std::endl;
+    }
+}
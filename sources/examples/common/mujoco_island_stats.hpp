@@ -0,0 +1,83 @@
+#pragma once
+
+#include <mujoco/mujoco.h>
+#include <map>
+#include <ostream>
+
+class WorkerPool;
+
+/**
+ * @file mujoco_island_stats.hpp
+ * @brief 制約の島（mj_island）の計測と、島ごとの並列求解モード
+ *
+ * `mjENBL_ISLAND` を有効にすると、MuJoCo は制約を互いに独立な島（dof と制約の連結成分）に分けて解く。
+ * 接触が重ならないロボット群（例: FleetBuilder の tb3 群）では、ロボット1台がおおよそ1つの島になる。
+ *
+ * IslandMonitor は mj_step の後に呼び出し、ステップごとの島の数と大きさ（dof 数・制約数）を集計する。
+ * `mjData::solver_nisland` も記録するので、ソルバが実際に島ごとに解いたかを確認できる
+ * （ソルバの種類やバージョンによっては島に分けずに全体を1度に解く）。
+ *
+ * IslandStepMode::Parallel は実験的なモードで、島を有効にしたうえで WorkerPool の `mjThreadPool` を
+ * `mju_bindThreadPool` で mjData に結び付ける。独立な島の求解を MuJoCo がプール上で並行に処理するため、
+ * 島の数が多く1つ1つが小さい場面でのみ効果がある。結果は逐次実行と同じになるとは限らない。
+ */
+
+enum class IslandStepMode {
+    Off,        ///< 島を使わない（全制約を1度に解く）
+    Serial,     ///< 島ごとに解く（呼び出しスレッドのみ）
+    Parallel,   ///< 島ごとに解き、スレッドプールで並行に処理する（実験的）
+};
+
+/**
+ * @brief モードを model / data に設定する
+ * @param pool Parallel で使うプール（Off / Serial では無視し、data のプールを外す）
+ * @return Parallel でプールがない（ワーカー数 1）場合 false（Serial として設定される）
+ * @note model->opt.enableflags を書き換えるため、同じモデルを共有する他の mjData にも影響する
+ */
+bool configure_island_stepping(mjModel* model, mjData* data, IslandStepMode mode, const WorkerPool* pool);
+
+/**
+ * @brief モード名（"off" / "serial" / "parallel"）
+ */
+const char* island_step_mode_name(IslandStepMode mode);
+
+/**
+ * @brief 島の集計
+ */
+class IslandMonitor {
+public:
+    /**
+     * @brief 直前の mj_step（mj_forward）で求めた島を集計する
+     */
+    void record(const mjData* data);
+
+    void clear() { *this = IslandMonitor(); }
+
+    long long steps() const { return steps_; }
+    double mean_islands() const { return steps_ ? static_cast<double>(islands_) / steps_ : 0; }
+    int max_islands() const { return max_islands_; }
+    double mean_solver_islands() const { return steps_ ? static_cast<double>(solver_islands_) / steps_ : 0; }
+    int max_island_dofs() const { return max_dofs_; }
+    int max_island_efcs() const { return max_efcs_; }
+
+    /**
+     * @brief 島の dof 数ごとの出現回数（全ステップの合計）
+     */
+    const std::map<int, long long>& dof_histogram() const { return dof_histogram_; }
+
+    /**
+     * @brief 集計を表示する
+     */
+    void print(std::ostream& out) const;
+
+private:
+    long long steps_ = 0;
+    long long islands_ = 0;
+    long long solver_islands_ = 0;
+    long long efcs_ = 0;
+    long long island_efcs_ = 0;     // 島に属する制約の数
+    int max_islands_ = 0;
+    int max_dofs_ = 0;
+    int max_efcs_ = 0;
+    std::map<int, long long> dof_histogram_;
+};
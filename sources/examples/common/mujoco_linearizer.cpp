@@ -0,0 +1,154 @@
+#include "mujoco_linearizer.hpp"
+#include <cmath>
+#include <iterator>
+
+// 動作点として比較する状態の要素
+static const unsigned int kOperatingPointSpec = mjSTATE_QPOS | mjSTATE_QVEL | mjSTATE_ACT | mjSTATE_CTRL;
+
+size_t Linearizer::KeyHash::operator()(const std::vector<long long>& key) const {
+    // FNV-1a
+    size_t hash = 1469598103934665603ULL;
+    for (long long v : key) {
+        hash ^= static_cast<size_t>(v);
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+Linearizer::Linearizer(const mjModel* model, int nworker, mjtNum eps, mjtNum cache_resolution, int cache_capacity)
+    : model_(model),
+      eps_(eps),
+      cache_resolution_(cache_resolution),
+      nx_(2 * model->nv + model->na),
+      nstate_(mj_stateSize(model, mjSTATE_INTEGRATION)),
+      pool_(nworker),
+      state0_(nstate_),
+      next_qpos_(model->nq),
+      next_qvel_(model->nv),
+      next_act_(model->na),
+      target_(nullptr),
+      cache_capacity_(cache_capacity > 0 ? cache_capacity : 1),
+      cache_hits_(0),
+      cache_misses_(0) {
+    for (int i = 0; i < pool_.size(); i++) {
+        worker_data_.push_back(mj_makeData(model_));
+        worker_dx_.emplace_back(nx_ + model_->nv);
+    }
+}
+
+Linearizer::~Linearizer() {
+    for (mjData* d : worker_data_) {
+        mj_deleteData(d);
+    }
+}
+
+void Linearizer::make_key(const mjData* data, std::vector<long long>& key) {
+    point_.resize(mj_stateSize(model_, kOperatingPointSpec));
+    mj_getState(model_, data, point_.data(), kOperatingPointSpec);
+    key.resize(point_.size());
+    for (size_t i = 0; i < point_.size(); i++) {
+        key[i] = std::llround(point_[i] / cache_resolution_);
+    }
+}
+
+const Linearization& Linearizer::linearize(const mjData* data) {
+    make_key(data, key_);
+    auto it = cache_.find(key_);
+    if (it != cache_.end()) {
+        cache_hits_++;
+        lru_.splice(lru_.begin(), lru_, it->second);
+        return it->second->second;
+    }
+    cache_misses_++;
+
+    // 容量を超える場合は最も長く使われていない動作点を捨て、その領域を使い回す
+    if (static_cast<int>(cache_.size()) >= cache_capacity_) {
+        cache_.erase(lru_.back().first);
+        lru_.splice(lru_.begin(), lru_, std::prev(lru_.end()));
+        lru_.front().first = key_;
+    } else {
+        lru_.emplace_front(key_, Linearization());
+    }
+    cache_[key_] = lru_.begin();
+    Linearization& result = lru_.front().second;
+    compute(data, result);
+    return result;
+}
+
+void Linearizer::clear_cache() {
+    cache_.clear();
+    lru_.clear();
+}
+
+void Linearizer::compute(const mjData* data, Linearization& out) {
+    const int nv = model_->nv;
+    const int nu = model_->nu;
+    out.nx = nx_;
+    out.nu = nu;
+    out.A.assign(nx_ * nx_, 0);
+    out.B.assign(nx_ * nu, 0);
+
+    // 公称の次状態を求める
+    mj_getState(model_, data, state0_.data(), mjSTATE_INTEGRATION);
+    mjData* d = worker_data_[0];
+    mj_setState(model_, d, state0_.data(), mjSTATE_INTEGRATION);
+    mj_step(model_, d);
+    mju_copy(next_qpos_.data(), d->qpos, model_->nq);
+    mju_copy(next_qvel_.data(), d->qvel, nv);
+    mju_copy(next_act_.data(), d->act, model_->na);
+
+    // 摂動列をワーカーに分割する
+    target_ = &out;
+    pool_.parallel_for(nx_ + nu, [this](int worker, int begin, int end) {
+        for (int col = begin; col < end; col++) {
+            perturb_column(worker, col);
+        }
+    });
+    target_ = nullptr;
+}
+
+void Linearizer::perturb_column(int worker, int col) {
+    const int nv = model_->nv;
+    const int na = model_->na;
+    mjData* d = worker_data_[worker];
+    mjtNum* dx = worker_dx_[worker].data();
+    mjtNum* dq = dx + nx_;
+    mjtNum eps = eps_;
+
+    mj_setState(model_, d, state0_.data(), mjSTATE_INTEGRATION);
+    if (col < nv) {
+        // 位置は接空間で摂動する（フリージョイントやボールジョイントのクォータニオン対策）
+        mju_zero(dq, nv);
+        dq[col] = 1;
+        mj_integratePos(model_, d->qpos, dq, eps);
+    } else if (col < 2 * nv) {
+        d->qvel[col - nv] += eps;
+    } else if (col < nx_) {
+        d->act[col - 2 * nv] += eps;
+    } else {
+        // 制御範囲の上限を超える場合は後退差分にする
+        int k = col - nx_;
+        bool clamp = model_->actuator_ctrllimited[k] && !(model_->opt.disableflags & mjDSBL_CLAMPCTRL);
+        if (clamp && d->ctrl[k] + eps > model_->actuator_ctrlrange[2 * k + 1]) {
+            eps = -eps;
+        }
+        d->ctrl[k] += eps;
+    }
+    mj_step(model_, d);
+
+    mj_differentiatePos(model_, dx, 1.0, next_qpos_.data(), d->qpos);
+    for (int i = 0; i < nv; i++) {
+        dx[nv + i] = d->qvel[i] - next_qvel_[i];
+    }
+    for (int i = 0; i < na; i++) {
+        dx[2 * nv + i] = d->act[i] - next_act_[i];
+    }
+
+    // 列ごとに書き込み先が分かれているためワーカー間で競合しない
+    mjtNum* mat = col < nx_ ? target_->A.data() : target_->B.data();
+    int ncol = col < nx_ ? nx_ : target_->nu;
+    int c = col < nx_ ? col : col - nx_;
+    for (int r = 0; r < nx_; r++) {
+        mat[r * ncol + c] = dx[r] / eps;
+    }
+}
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <mujoco/mujoco.h>
+#include <list>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "mujoco_thread_pool.hpp"
+
+/**
+ * @file mujoco_linearizer.hpp
+ * @brief 有限差分による離散時間ダイナミクスの線形化サービス
+ *
+ * `mjd_transitionFD` と同じ定義で遷移行列を求める。
+ *   d(x_next) = A * dx + B * du
+ *   x = [qpos の接空間差分 (nv), qvel (nv), act (na)]
+ *
+ * 摂動する列（状態 2*nv+na 列 + 制御 nu 列）をワーカーに分割し、
+ * 各ワーカーは専用の `mjData` で `mj_step` を実行する。
+ * 結果は動作点（qpos, qvel, act, ctrl を量子化した値）をキーにキャッシュする。
+ * 制御周期で呼び続けるとほぼ毎回キャッシュに外れるため、キャッシュは容量を超えると
+ * 最も長く使われていない動作点から捨てる（LRU）。
+ */
+
+/**
+ * @brief 線形化結果
+ */
+struct Linearization {
+    int nx = 0;              ///< 状態の次元 (2*nv + na)
+    int nu = 0;              ///< 制御入力の次元
+    std::vector<mjtNum> A;   ///< 状態遷移行列 (nx x nx, 行優先)
+    std::vector<mjtNum> B;   ///< 入力行列 (nx x nu, 行優先)
+};
+
+class Linearizer {
+public:
+    /**
+     * @brief 線形化サービスを生成する
+     * @param model MuJoCoのモデルデータ（Linearizer より長く生存すること）
+     * @param nworker 有限差分に使うワーカー数
+     * @param eps 有限差分の摂動幅
+     * @param cache_resolution キャッシュキーを作る際の量子化幅
+     * @param cache_capacity キャッシュする動作点の最大数（1 未満は 1）
+     */
+    Linearizer(const mjModel* model, int nworker, mjtNum eps = 1e-6, mjtNum cache_resolution = 1e-4,
+               int cache_capacity = 256);
+    ~Linearizer();
+
+    Linearizer(const Linearizer&) = delete;
+    Linearizer& operator=(const Linearizer&) = delete;
+
+    /**
+     * @brief data の状態・制御入力を動作点として線形化する（キャッシュ付き）
+     * @param data 動作点を保持するシミュレーションデータ（変更しない）
+     * @return 線形化結果（キャッシュから追い出されるか clear_cache() を呼ぶまで有効。
+     *         少なくとも次の linearize() までは有効）
+     * @note 同時に呼び出せるのは1スレッドのみ
+     */
+    const Linearization& linearize(const mjData* data);
+
+    /**
+     * @brief キャッシュを使わずに線形化する
+     * @param data 動作点を保持するシミュレーションデータ（変更しない）
+     * @param out 出力先
+     */
+    void compute(const mjData* data, Linearization& out);
+
+    /**
+     * @brief キャッシュを破棄する
+     */
+    void clear_cache();
+
+    int cache_size() const { return static_cast<int>(cache_.size()); }
+    int cache_capacity() const { return cache_capacity_; }
+    long cache_hits() const { return cache_hits_; }
+    long cache_misses() const { return cache_misses_; }
+
+private:
+    struct KeyHash {
+        size_t operator()(const std::vector<long long>& key) const;
+    };
+    using CacheEntry = std::pair<std::vector<long long>, Linearization>;
+
+    void make_key(const mjData* data, std::vector<long long>& key);
+    void perturb_column(int worker, int col);
+
+    const mjModel* model_;
+    mjtNum eps_;
+    mjtNum cache_resolution_;
+    int nx_;
+    int nstate_;
+
+    WorkerPool pool_;
+    std::vector<mjData*> worker_data_;
+    std::vector<std::vector<mjtNum>> worker_dx_;
+
+    // 現在計算中の動作点と、その公称の次状態
+    std::vector<mjtNum> state0_;
+    std::vector<mjtNum> next_qpos_;
+    std::vector<mjtNum> next_qvel_;
+    std::vector<mjtNum> next_act_;
+    Linearization* target_;
+
+    // 先頭が最近使った動作点
+    int cache_capacity_;
+    std::list<CacheEntry> lru_;
+    std::unordered_map<std::vector<long long>, std::list<CacheEntry>::iterator, KeyHash> cache_;
+    std::vector<mjtNum> point_;
+    std::vector<long long> key_;
+    long cache_hits_;
+    long cache_misses_;
+};
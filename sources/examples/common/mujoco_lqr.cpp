@@ -0,0 +1,64 @@
+#include "mujoco_lqr.hpp"
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+bool solve_discrete_lqr(const mjtNum* A, const mjtNum* B, const mjtNum* Q, const mjtNum* R,
+                        int nx, int nu, mjtNum* K, int max_iter, mjtNum tol) {
+    std::vector<mjtNum> P(Q, Q + nx * nx);
+    std::vector<mjtNum> P_next(nx * nx);
+    std::vector<mjtNum> PA(nx * nx), PB(nx * nu);
+    std::vector<mjtNum> BtPA(nu * nx), S(nu * nu);
+    std::vector<mjtNum> AtPA(nx * nx), correction(nx * nx);
+    std::vector<mjtNum> rhs(nu), sol(nu);
+
+    for (int iter = 0; iter < max_iter; iter++) {
+        // S = R + B' P B,  K = S^-1 B' P A
+        mju_mulMatMat(PA.data(), P.data(), A, nx, nx, nx);
+        mju_mulMatMat(PB.data(), P.data(), B, nx, nx, nu);
+        mju_mulMatTMat(BtPA.data(), B, PA.data(), nx, nu, nx);
+        mju_mulMatTMat(S.data(), B, PB.data(), nx, nu, nu);
+        for (int i = 0; i < nu * nu; i++) {
+            S[i] += R[i];
+        }
+        if (mju_cholFactor(S.data(), nu, mjMINVAL) != nu) {
+            std::cerr << "[ERROR] LQR: R + B'PB is not positive definite" << std::endl;
+            return false;
+        }
+        for (int c = 0; c < nx; c++) {
+            for (int r = 0; r < nu; r++) {
+                rhs[r] = BtPA[r * nx + c];
+            }
+            mju_cholSolve(sol.data(), S.data(), rhs.data(), nu);
+            for (int r = 0; r < nu; r++) {
+                K[r * nx + c] = sol[r];
+            }
+        }
+
+        // P = Q + A' P A - (B' P A)' K
+        mju_mulMatTMat(AtPA.data(), A, PA.data(), nx, nx, nx);
+        mju_mulMatTMat(correction.data(), BtPA.data(), K, nu, nx, nx);
+        for (int i = 0; i < nx; i++) {
+            for (int j = 0; j < nx; j++) {
+                int ij = i * nx + j;
+                P_next[ij] = Q[ij] + AtPA[ij] - correction[ij];
+            }
+        }
+        mjtNum change = 0;
+        mjtNum scale = 1;
+        for (int i = 0; i < nx; i++) {
+            for (int j = 0; j < nx; j++) {
+                // 数値誤差で対称性が崩れないようにする
+                mjtNum value = 0.5 * (P_next[i * nx + j] + P_next[j * nx + i]);
+                change = std::fmax(change, std::abs(value - P[i * nx + j]));
+                scale = std::fmax(scale, std::abs(value));
+                P[i * nx + j] = value;
+            }
+        }
+        if (change < tol * scale) {
+            return true;
+        }
+    }
+    std::cerr << "[ERROR] LQR: Riccati iteration did not converge" << std::endl;
+    return false;
+}
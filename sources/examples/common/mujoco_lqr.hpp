@@ -0,0 +1,28 @@
+#pragma once
+
+#include <mujoco/mujoco.h>
+
+/**
+ * @file mujoco_lqr.hpp
+ * @brief 離散時間LQRのゲイン計算
+ */
+
+/**
+ * @brief 離散時間リカッチ方程式を反復法で解き、LQRゲインを求める
+ *
+ * u = -K x で x_next = A x + B u を安定化するゲイン K を計算する。
+ * 行列はすべて行優先。
+ *
+ * @param A 状態遷移行列 (nx x nx)
+ * @param B 入力行列 (nx x nu)
+ * @param Q 状態の重み (nx x nx)
+ * @param R 入力の重み (nu x nu)
+ * @param nx 状態の次元
+ * @param nu 入力の次元
+ * @param K 出力ゲイン (nu x nx)
+ * @param max_iter 最大反復回数
+ * @param tol 収束判定（P の要素の最大変化量を P の最大要素で正規化した値）
+ * @return 収束した場合 true
+ */
+bool solve_discrete_lqr(const mjtNum* A, const mjtNum* B, const mjtNum* Q, const mjtNum* R,
+                        int nx, int nu, mjtNum* K, int max_iter = 10000, mjtNum tol = 1e-9);
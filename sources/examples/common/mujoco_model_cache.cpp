@@ -0,0 +1,48 @@
+#include "mujoco_model_cache.hpp"
+#include <iostream>
+
+ModelCache::~ModelCache() {
+    clear();
+}
+
+const mjModel* ModelCache::find(const std::string& key) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = models_.find(key);
+    return it != models_.end() ? it->second : nullptr;
+}
+
+const mjModel* ModelCache::insert(const std::string& key, mjModel* model) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto result = models_.emplace(key, model);
+    if (!result.second && result.first->second != model) {
+        mj_deleteModel(model);
+    }
+    return result.first->second;
+}
+
+const mjModel* ModelCache::load(const std::string& path) {
+    const mjModel* cached = find(path);
+    if (cached) {
+        return cached;
+    }
+    char error[1000];
+    mjModel* model = mj_loadXML(path.c_str(), nullptr, error, sizeof(error));
+    if (!model) {
+        std::cerr << "[ERROR] Failed to load model: " << path << "\n" << error << std::endl;
+        return nullptr;
+    }
+    return insert(path, model);
+}
+
+int ModelCache::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return static_cast<int>(models_.size());
+}
+
+void ModelCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& entry : models_) {
+        mj_deleteModel(entry.second);
+    }
+    models_.clear();
+}
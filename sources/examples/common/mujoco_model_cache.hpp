@@ -0,0 +1,59 @@
+#pragma once
+
+#include <mujoco/mujoco.h>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+/**
+ * @file mujoco_model_cache.hpp
+ * @brief コンパイル済みモデルのキャッシュ
+ *
+ * キー（ファイル名やバリアント名）ごとにコンパイル済みの mjModel を保持する。
+ * 登録したモデルの所有権はキャッシュに移り、キャッシュの破棄時に削除される。
+ * すべての操作はスレッドセーフ。
+ */
+class ModelCache {
+public:
+    ModelCache() = default;
+    ~ModelCache();
+
+    ModelCache(const ModelCache&) = delete;
+    ModelCache& operator=(const ModelCache&) = delete;
+
+    /**
+     * @brief キーに対応するモデルを取得する
+     * @return 見つからない場合は nullptr
+     */
+    const mjModel* find(const std::string& key) const;
+
+    /**
+     * @brief モデルを登録する
+     *
+     * 同じキーが登録済みの場合は既存のモデルを残し、渡したモデルを削除する
+     * （取得済みのポインタを無効にしないため）。
+     *
+     * @param key キー
+     * @param model 登録するモデル（所有権はキャッシュに移る）
+     * @return キャッシュ内のモデル
+     */
+    const mjModel* insert(const std::string& key, mjModel* model);
+
+    /**
+     * @brief ファイルからモデルを読み込み、キャッシュする（キャッシュ済みなら再利用）
+     * @param path MJCF ファイルのパス
+     * @return 読み込みに失敗した場合は nullptr
+     */
+    const mjModel* load(const std::string& path);
+
+    int size() const;
+
+    /**
+     * @brief 全モデルを削除する（取得済みのポインタは無効になる）
+     */
+    void clear();
+
+private:
+    mutable std::mutex mutex_;
+    std::unordered_map<std::string, mjModel*> models_;
+};
@@ -0,0 +1,121 @@
+#include "mujoco_model_reloader.hpp"
+#include "mujoco_state_view.hpp"
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace {
+
+// 名前で対応付けて引き継ぐ状態
+struct NamedState {
+    std::string name;
+    int type;
+    std::vector<mjtNum> qpos;
+    std::vector<mjtNum> qvel;
+};
+
+}  // namespace
+
+ModelReloader::ModelReloader(const std::string& path, mjModel* model, mjData* data, std::mutex& mutex)
+    : path_(path), model_(model), data_(data), mutex_(mutex) {
+    std::error_code ec;
+    last_write_ = std::filesystem::last_write_time(path_, ec);
+}
+
+bool ModelReloader::poll() {
+    std::error_code ec;
+    auto write_time = std::filesystem::last_write_time(path_, ec);
+    if (ec || write_time == last_write_) {
+        return false;
+    }
+    last_write_ = write_time;
+    return reload();
+}
+
+bool ModelReloader::reload() {
+    char error[1000];
+    std::cout << "[INFO] Reloading model: " << path_ << std::endl;
+    mjSpec* spec = mj_parseXML(path_.c_str(), nullptr, error, sizeof(error));
+    if (!spec) {
+        std::cerr << "[ERROR] Failed to parse model: " << path_ << "\n" << error << std::endl;
+        return false;
+    }
+
+    // 編集途中の不正なファイルで実行中のモデルを壊さないよう、ロックの外で一度コンパイルを試す
+    mjModel* trial = mj_compile(spec, nullptr);
+    if (!trial) {
+        std::cerr << "[ERROR] Failed to compile model: " << path_ << "\n" << mjs_getError(spec) << std::endl;
+        mj_deleteSpec(spec);
+        return false;
+    }
+    mj_deleteModel(trial);
+
+    bool ok = true;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        // 現在の状態を名前付きで退避する
+        mjtNum time = data_->time;
+        std::vector<NamedState> joints;
+        for (int j = 0; j < model_->njnt; j++) {
+            const char* name = mj_id2name(model_, mjOBJ_JOINT, j);
+            if (!name) {
+                continue;
+            }
+            int type = model_->jnt_type[j];
+            const mjtNum* qpos = data_->qpos + model_->jnt_qposadr[j];
+            const mjtNum* qvel = data_->qvel + model_->jnt_dofadr[j];
+            joints.push_back({name, type,
+                              std::vector<mjtNum>(qpos, qpos + joint_qpos_size(type)),
+                              std::vector<mjtNum>(qvel, qvel + joint_dof_size(type))});
+        }
+        std::vector<std::pair<std::string, mjtNum>> ctrls;
+        for (int i = 0; i < model_->nu; i++) {
+            const char* name = mj_id2name(model_, mjOBJ_ACTUATOR, i);
+            if (name) {
+                ctrls.emplace_back(name, data_->ctrl[i]);
+            }
+        }
+
+        if (mj_recompile(spec, nullptr, model_, data_) != 0) {
+            std::cerr << "[ERROR] mj_recompile failed: " << mjs_getError(spec) << std::endl;
+            ok = false;
+        } else {
+            // 名前が一致し、種類が同じジョイントの状態を戻す
+            for (const NamedState& joint : joints) {
+                int j = mj_name2id(model_, mjOBJ_JOINT, joint.name.c_str());
+                if (j == -1 || model_->jnt_type[j] != joint.type) {
+                    continue;
+                }
+                mju_copy(data_->qpos + model_->jnt_qposadr[j], joint.qpos.data(), joint_qpos_size(joint.type));
+                mju_copy(data_->qvel + model_->jnt_dofadr[j], joint.qvel.data(), joint_dof_size(joint.type));
+            }
+            for (const auto& ctrl : ctrls) {
+                int i = mj_name2id(model_, mjOBJ_ACTUATOR, ctrl.first.c_str());
+                if (i != -1) {
+                    data_->ctrl[i] = ctrl.second;
+                }
+            }
+            data_->time = time;
+            mj_forward(model_, data_);
+            if (hook_) {
+                hook_(model_);
+            }
+        }
+    }
+    mj_deleteSpec(spec);
+
+    if (ok) {
+        std::cout << "[INFO] Model reloaded (nq=" << model_->nq << ", nbody=" << model_->nbody << ")" << std::endl;
+    }
+    return ok;
+}
+
+void model_watcher_thread(ModelReloader& reloader, bool& running_flag, int interval_ms) {
+    while (running_flag) {
+        reloader.poll();
+        std::this_thread::sleep_for(std::chrono::milliseconds(interval_ms));
+    }
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <mujoco/mujoco.h>
+#include <filesystem>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <utility>
+
+/**
+ * @file mujoco_model_reloader.hpp
+ * @brief MJCF ファイルの変更を監視し、シミュレーション状態を保ったままモデルを再コンパイルする
+ *
+ * 変更を検出すると MJCF を `mj_parseXML` で読み直し、排他制御用ミューテックスの下で
+ * 実行中の mjModel / mjData に対して `mj_recompile` を行う。
+ * mjModel / mjData のポインタは変わらないため、シミュレーションスレッドとビューアスレッドは
+ * 再起動せずにそのまま新しいモデルを使い続けられる。
+ * ジョイントの位置・速度とアクチュエータの入力は名前で対応付けて引き継ぐ。
+ * 要素の ID やアドレスはモデルが変わると変わるため、それらを保持している側は
+ * set_reload_hook() で登録した関数で引き直す（AsyncLogger::rebind など）。
+ *
+ * @note ビューアの描画コンテキスト（テクスチャ・メッシュ）は起動時のものが使われ続ける
+ */
+class ModelReloader {
+public:
+    /**
+     * @param path 監視する MJCF ファイルのパス
+     * @param model 実行中のモデル
+     * @param data 実行中のシミュレーションデータ
+     * @param mutex MuJoCoデータの排他制御用ミューテックス（シミュレーション・ビューアと共有）
+     */
+    ModelReloader(const std::string& path, mjModel* model, mjData* data, std::mutex& mutex);
+
+    /**
+     * @brief 再コンパイルに成功した直後に、ミューテックスを保持したまま呼ぶ関数を登録する
+     */
+    void set_reload_hook(std::function<void(const mjModel* model)> hook) { hook_ = std::move(hook); }
+
+    /**
+     * @brief ファイルが更新されていれば再読み込みする
+     * @return 再読み込みに成功した場合 true
+     */
+    bool poll();
+
+    /**
+     * @brief ファイルを読み直し、モデルを再コンパイルする
+     * @return 成功した場合 true（失敗時は実行中のモデルをそのまま使う）
+     */
+    bool reload();
+
+private:
+    std::string path_;
+    mjModel* model_;
+    mjData* data_;
+    std::mutex& mutex_;
+    std::filesystem::file_time_type last_write_;
+    std::function<void(const mjModel*)> hook_;
+};
+
+/**
+ * @brief モデル監視スレッド
+ * @param reloader 再読み込みを行うオブジェクト
+ * @param running_flag シミュレーションの実行フラグ
+ * @param interval_ms 監視間隔
+ */
+void model_watcher_thread(ModelReloader& reloader, bool& running_flag, int interval_ms);
@@ -0,0 +1,158 @@
+#include "mujoco_quiescence.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include "mujoco_thread_pool.hpp"
+
+namespace {
+
+bool all_zero(const mjtNum* values, int n) {
+    for (int i = 0; i < n; i++) {
+        if (values[i] != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool all_below(const mjtNum* values, int n, double threshold) {
+    for (int i = 0; i < n; i++) {
+        if (std::fabs(values[i]) > threshold) {
+            return false;
+        }
+    }
+    return true;
+}
+
+}  // namespace
+
+bool QuiescenceDetector::update(const mjModel* model, const mjData* data, const QuiescenceOptions& options) {
+    std::vector<std::pair<int, int>> contacts;
+    contacts.reserve(data->ncon);
+    for (int i = 0; i < data->ncon; i++) {
+        contacts.emplace_back(data->contact[i].geom[0], data->contact[i].geom[1]);
+    }
+    std::sort(contacts.begin(), contacts.end());
+    bool same_contacts = contacts == contacts_;
+    contacts_.swap(contacts);
+
+    bool still = same_contacts && all_below(data->ctrl, model->nu, options.ctrl_threshold) &&
+                 all_below(data->qvel, model->nv, options.qvel_threshold);
+    settled_steps_ = still ? settled_steps_ + 1 : 0;
+    return settled_steps_ >= options.settle_steps;
+}
+
+void QuiescenceDetector::reset() {
+    settled_steps_ = 0;
+    contacts_.clear();
+}
+
+SleepingFleet::SleepingFleet(const mjModel* model, int robots, const QuiescenceOptions& options)
+    : model_(model), options_(options) {
+    for (int b = 1; b < model->nbody; b++) {
+        if (model->body_parentid[b] == 0) {
+            root_body_ = b;
+            break;
+        }
+    }
+    datas_.resize(robots);
+    for (mjData*& d : datas_) {
+        d = mj_makeData(model);
+    }
+    awake_.assign(robots, 1);
+    settled_.assign(robots, 0);
+    detectors_.resize(robots);
+    sleep_ctrl_.assign(static_cast<size_t>(model->nu) * robots, 0);
+}
+
+SleepingFleet::~SleepingFleet() {
+    for (mjData* d : datas_) {
+        mj_deleteData(d);
+    }
+}
+
+int SleepingFleet::active() const {
+    return static_cast<int>(std::count(awake_.begin(), awake_.end(), 1));
+}
+
+void SleepingFleet::wake(int index) {
+    if (!awake_[index]) {
+        awake_[index] = 1;
+        datas_[index]->time = time_;
+    }
+    detectors_[index].reset();
+}
+
+void SleepingFleet::sleep(int index) {
+    mjData* d = datas_[index];
+    mju_zero(d->qvel, model_->nv);
+    mju_zero(d->qacc_warmstart, model_->nv);
+    std::memcpy(sleep_ctrl_.data() + static_cast<size_t>(index) * model_->nu, d->ctrl, sizeof(mjtNum) * model_->nu);
+    awake_[index] = 0;
+}
+
+bool SleepingFleet::should_wake(int index) const {
+    const mjData* d = datas_[index];
+    const mjtNum* ctrl = sleep_ctrl_.data() + static_cast<size_t>(index) * model_->nu;
+    for (int i = 0; i < model_->nu; i++) {
+        if (std::fabs(d->ctrl[i] - ctrl[i]) > options_.ctrl_threshold) {
+            return true;
+        }
+    }
+    if (!all_zero(d->xfrc_applied, 6 * model_->nbody) || !all_zero(d->qfrc_applied, model_->nv)) {
+        return true;
+    }
+    if (options_.wake_distance > 0) {
+        const mjtNum* pos = d->xpos + 3 * root_body_;
+        for (int other = 0; other < size(); other++) {
+            if (!awake_[other]) {
+                continue;
+            }
+            const mjtNum* p = datas_[other]->xpos + 3 * root_body_;
+            if (mju_dist3(pos, p) <= options_.wake_distance) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+int SleepingFleet::step(WorkerPool* pool) {
+    // 起こす判定は起きているロボットの位置を使うため、先に全て判定してから起こす
+    std::vector<int> wake_list;
+    for (int r = 0; r < size(); r++) {
+        if (!awake_[r] && should_wake(r)) {
+            wake_list.push_back(r);
+        }
+    }
+    for (int r : wake_list) {
+        wake(r);
+    }
+
+    active_.clear();
+    for (int r = 0; r < size(); r++) {
+        if (awake_[r]) {
+            active_.push_back(r);
+        }
+    }
+    auto advance = [this](int, int begin, int end) {
+        for (int i = begin; i < end; i++) {
+            int r = active_[i];
+            mj_step(model_, datas_[r]);
+            settled_[r] = detectors_[r].update(model_, datas_[r], options_);
+        }
+    };
+    if (pool) {
+        pool->parallel_for(static_cast<int>(active_.size()), advance);
+    } else {
+        advance(0, 0, static_cast<int>(active_.size()));
+    }
+
+    for (int r : active_) {
+        if (settled_[r]) {
+            sleep(r);
+        }
+    }
+    time_ += model_->opt.timestep;
+    return static_cast<int>(active_.size());
+}
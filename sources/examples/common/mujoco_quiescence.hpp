@@ -0,0 +1,111 @@
+#pragma once
+
+#include <mujoco/mujoco.h>
+#include <utility>
+#include <vector>
+
+class WorkerPool;
+
+/**
+ * @file mujoco_quiescence.hpp
+ * @brief 静止したロボットを眠らせてステップから外すフリート
+ *
+ * ロボット1台ごとに mjData を持ち（モデルは共有）、起きているロボットだけを mj_step で進める。
+ * 長時間のシミュレーションで多くのロボットが ctrl=0 のまま停車している場合、
+ * 1ステップのコストが全台数ではなく起きている台数に比例するようになる。
+ *
+ * 眠る条件（settle_steps ステップ連続で全て満たす）:
+ * - ctrl が全て |u| <= ctrl_threshold
+ * - qvel が全て |v| <= qvel_threshold
+ * - 接触しているジオムの組が変わらない
+ * 眠る時に qvel / qacc_warmstart を 0 にする（眠っている間の状態は完全に静止する）。
+ *
+ * 起きる条件（step() の最初に判定する）:
+ * - ctrl が眠った時の値から ctrl_threshold を超えて変わった
+ * - xfrc_applied / qfrc_applied に 0 でない値が書かれた
+ * - 起きているロボットのルートボディが wake_distance 以内に近づいた（接触が来る前に起こす）
+ * - wake() で明示的に起こした
+ *
+ * @note ロボットごとに別の mjData で進めるため、ロボット同士の接触は計算しない
+ *       （FleetMode::Isolated と同じ扱い）。ワールドのジオムとの接触は計算する。
+ */
+
+/**
+ * @brief 判定の設定
+ */
+struct QuiescenceOptions {
+    double qvel_threshold = 1e-3;   ///< 静止とみなす速度 [m/s, rad/s]
+    double ctrl_threshold = 1e-9;   ///< 0 とみなす ctrl
+    int settle_steps = 50;          ///< 眠るまでに条件を満たし続けるステップ数
+    double wake_distance = 0.5;     ///< 起きているロボットが近づいた時に起こす距離 [m]（0 以下で無効）
+};
+
+/**
+ * @brief ロボット1台の静止判定
+ */
+class QuiescenceDetector {
+public:
+    /**
+     * @brief mj_step の後に呼ぶ
+     * @return settle_steps ステップ連続で静止している場合 true
+     */
+    bool update(const mjModel* model, const mjData* data, const QuiescenceOptions& options);
+
+    void reset();
+
+private:
+    int settled_steps_ = 0;
+    std::vector<std::pair<int, int>> contacts_;  // 前のステップで接触していたジオムの組
+};
+
+class SleepingFleet {
+public:
+    /**
+     * @param model ロボット1台のモデル（全台で共有する、ルートボディは自由関節）
+     * @param robots 台数（各 mjData は model の初期状態で作る）
+     * @param options 判定の設定
+     */
+    SleepingFleet(const mjModel* model, int robots, const QuiescenceOptions& options = QuiescenceOptions());
+    ~SleepingFleet();
+
+    SleepingFleet(const SleepingFleet&) = delete;
+    SleepingFleet& operator=(const SleepingFleet&) = delete;
+
+    int size() const { return static_cast<int>(datas_.size()); }
+
+    /**
+     * @brief ロボット index の mjData（ctrl などを書き換えてから step() を呼ぶ）
+     */
+    mjData* data(int index) { return datas_[index]; }
+
+    bool awake(int index) const { return awake_[index] != 0; }
+    int active() const;
+    double time() const { return time_; }
+
+    /**
+     * @brief ロボット index を起こす（眠っていない場合は静止判定をやり直す）
+     */
+    void wake(int index);
+
+    /**
+     * @brief 起こす条件を判定し、起きているロボットを1ステップ進め、静止したロボットを眠らせる
+     * @param pool 起きているロボットを並列に進めるプール（nullptr で逐次）
+     * @return このステップで進めたロボットの数
+     */
+    int step(WorkerPool* pool = nullptr);
+
+private:
+    void sleep(int index);
+    bool should_wake(int index) const;
+
+    const mjModel* model_;
+    QuiescenceOptions options_;
+    int root_body_ = 1;
+    double time_ = 0;
+    std::vector<mjData*> datas_;
+    std::vector<char> awake_;                   // vector<bool> は並列に書けないため char
+    std::vector<char> settled_;
+    std::vector<QuiescenceDetector> detectors_;
+    std::vector<mjtNum> sleep_ctrl_;            // 眠った時の ctrl（nu x robots）
+    std::vector<int> active_;                   // このステップで進めるロボット
+};
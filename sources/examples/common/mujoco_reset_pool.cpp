@@ -0,0 +1,66 @@
+#include "mujoco_reset_pool.hpp"
+#include <cstring>
+#include <iostream>
+
+ResetPool::ResetPool(const mjModel* model)
+    : model_(model),
+      state_size_(mj_stateSize(model, mjSTATE_INTEGRATION)),
+      count_(0),
+      scratch_(mj_makeData(model)) {}
+
+ResetPool::~ResetPool() {
+    mj_deleteData(scratch_);
+}
+
+int ResetPool::capture(const mjData* data) {
+    states_.resize(static_cast<size_t>(count_ + 1) * state_size_);
+    mj_getState(model_, data, states_.data() + static_cast<size_t>(count_) * state_size_, mjSTATE_INTEGRATION);
+    return count_++;
+}
+
+int ResetPool::add_default() {
+    mj_resetData(model_, scratch_);
+    return capture(scratch_);
+}
+
+int ResetPool::add_keyframe(int key) {
+    if (key < 0 || key >= model_->nkey) {
+        std::cerr << "[ERROR] Keyframe not found: " << key << " (nkey=" << model_->nkey << ")" << std::endl;
+        return -1;
+    }
+    mj_resetDataKeyframe(model_, scratch_, key);
+    return capture(scratch_);
+}
+
+int ResetPool::add_sampled(int count, const ResetSamplerFn& sampler, unsigned int seed, int key) {
+    if (key >= model_->nkey) {
+        std::cerr << "[ERROR] Keyframe not found: " << key << " (nkey=" << model_->nkey << ")" << std::endl;
+        return 0;
+    }
+    std::mt19937 rng(seed);
+    states_.reserve(static_cast<size_t>(count_ + count) * state_size_);
+    for (int i = 0; i < count; i++) {
+        if (key >= 0) {
+            mj_resetDataKeyframe(model_, scratch_, key);
+        } else {
+            mj_resetData(model_, scratch_);
+        }
+        sampler(model_, scratch_, rng);
+        // クォータニオンを編集した場合に備えて正規化しておく
+        mj_normalizeQuat(model_, scratch_->qpos);
+        capture(scratch_);
+    }
+    return count;
+}
+
+void ResetPool::reset(mjData* data, int index) const {
+    if (count_ == 0) {
+        mj_resetData(model_, data);
+        mj_forward(model_, data);
+        return;
+    }
+    mj_setState(model_, data, state(index % count_), mjSTATE_INTEGRATION);
+    // mj_resetData と同様に警告の統計を消す（qacc_warmstart などは状態に含まれる）
+    std::memset(data->warning, 0, sizeof(data->warning));
+    mj_forward(model_, data);
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <mujoco/mujoco.h>
+#include <functional>
+#include <random>
+#include <vector>
+
+/**
+ * @file mujoco_reset_pool.hpp
+ * @brief エピソードの初期状態バンク
+ *
+ * 初期状態（キーフレーム、デフォルト状態、乱数で生成した状態）を `mj_getState` で
+ * 事前確保した連続配列に取り込んでおき、リセット時は `mj_setState` と `mj_forward` だけを行う。
+ * リセットのたびに `mj_resetData` を呼んだり mjData を作り直したりしない。
+ *
+ * 状態は `mjSTATE_INTEGRATION`（時刻・qpos・qvel・act・warmstart・ctrl・外力・mocap など）を保存する。
+ */
+
+/**
+ * @brief 初期状態を乱数で変える関数（デフォルト状態などにリセットされた data を編集する）
+ */
+using ResetSamplerFn = std::function<void(const mjModel* model, mjData* data, std::mt19937& rng)>;
+
+class ResetPool {
+public:
+    /**
+     * @param model MuJoCoのモデルデータ（ResetPool より長く生存すること）
+     */
+    explicit ResetPool(const mjModel* model);
+    ~ResetPool();
+
+    ResetPool(const ResetPool&) = delete;
+    ResetPool& operator=(const ResetPool&) = delete;
+
+    /**
+     * @brief `mj_resetData` の状態を追加する
+     * @return 追加した状態の番号
+     */
+    int add_default();
+
+    /**
+     * @brief キーフレームの状態を追加する
+     * @param key キーフレーム番号
+     * @return 追加した状態の番号（キーフレームが無い場合 -1）
+     */
+    int add_keyframe(int key);
+
+    /**
+     * @brief 乱数で生成した初期状態をまとめて追加する
+     * @param count 追加する数
+     * @param sampler 状態を編集する関数（キーフレームまたはデフォルト状態に対して呼ばれる）
+     * @param seed 乱数シード
+     * @param key 基準にするキーフレーム（-1 の場合はデフォルト状態）
+     * @return 追加した数
+     */
+    int add_sampled(int count, const ResetSamplerFn& sampler, unsigned int seed, int key = -1);
+
+    /**
+     * @brief 状態の数
+     */
+    int size() const { return count_; }
+
+    /**
+     * @brief 1状態あたりの要素数
+     */
+    int state_size() const { return state_size_; }
+
+    /**
+     * @brief 保存した状態
+     */
+    const mjtNum* state(int index) const { return states_.data() + static_cast<size_t>(index) * state_size_; }
+
+    /**
+     * @brief data を保存した状態に戻す（`mj_setState` + `mj_forward`、メモリ確保なし）
+     * @param data リセットするシミュレーションデータ
+     * @param index 状態の番号（size() で剰余を取る）
+     */
+    void reset(mjData* data, int index) const;
+
+private:
+    int capture(const mjData* data);
+
+    const mjModel* model_;
+    int state_size_;
+    int count_;
+    std::vector<mjtNum> states_;
+    mjData* scratch_;  // 状態を作るための作業用（リセット時には使わない）
+};
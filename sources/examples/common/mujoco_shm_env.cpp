@@ -0,0 +1,234 @@
+#include "mujoco_shm_env.hpp"
+#include <chrono>
+#include <climits>
+#include <iostream>
+#include <new>
+#include <thread>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
+
+// futex で眠る前にスピンする回数（応答が速い場合のシステムコールを避ける）
+static const int kSpinCount = 4000;
+
+// スピン中に CPU へ待機中であることを伝える（ハイパースレッドの相方に実行資源を譲る）
+static inline void cpu_relax() {
+#if defined(__x86_64__) || defined(__i386__)
+    _mm_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield");
+#else
+    std::this_thread::yield();
+#endif
+}
+
+static uint64_t align_up(uint64_t offset) {
+    return (offset + 63) & ~static_cast<uint64_t>(63);
+}
+
+ShmEnvRegion::ShmEnvRegion() : owner_(false), size_(0), header_(nullptr) {}
+
+ShmEnvRegion::~ShmEnvRegion() {
+    close();
+}
+
+void ShmEnvRegion::close() {
+    if (header_) {
+        munmap(header_, size_);
+        header_ = nullptr;
+    }
+    if (owner_) {
+        shm_unlink(name_.c_str());
+        owner_ = false;
+    }
+}
+
+bool ShmEnvRegion::create(const std::string& name, int num_envs, int nobs, int nu) {
+    close();
+    name_ = name;
+
+    // キャッシュラインごとに配列を配置する
+    uint64_t action_offset = align_up(sizeof(ShmEnvHeader));
+    uint64_t obs_offset = align_up(action_offset + sizeof(double) * num_envs * nu);
+    uint64_t reward_offset = align_up(obs_offset + sizeof(double) * num_envs * nobs);
+    uint64_t done_offset = align_up(reward_offset + sizeof(double) * num_envs);
+    uint64_t total_size = align_up(done_offset + sizeof(uint8_t) * num_envs);
+
+    shm_unlink(name_.c_str());  // 前回の異常終了で残った領域を削除
+    int fd = shm_open(name_.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd == -1) {
+        std::cerr << "[ERROR] shm_open failed: " << name_ << std::endl;
+        return false;
+    }
+    if (ftruncate(fd, static_cast<off_t>(total_size)) == -1) {
+        std::cerr << "[ERROR] ftruncate failed: " << name_ << std::endl;
+        ::close(fd);
+        shm_unlink(name_.c_str());
+        return false;
+    }
+    void* addr = mmap(nullptr, total_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (addr == MAP_FAILED) {
+        std::cerr << "[ERROR] mmap failed: " << name_ << std::endl;
+        shm_unlink(name_.c_str());
+        return false;
+    }
+    owner_ = true;
+    size_ = total_size;
+
+    header_ = new (addr) ShmEnvHeader();
+    header_->version = kShmEnvVersion;
+    header_->num_envs = num_envs;
+    header_->nobs = nobs;
+    header_->nu = nu;
+    header_->command = 0;
+    header_->request.seq.store(0, std::memory_order_relaxed);
+    header_->request.waiters.store(0, std::memory_order_relaxed);
+    header_->response.seq.store(0, std::memory_order_relaxed);
+    header_->response.waiters.store(0, std::memory_order_relaxed);
+    header_->action_offset = action_offset;
+    header_->obs_offset = obs_offset;
+    header_->reward_offset = reward_offset;
+    header_->done_offset = done_offset;
+    header_->total_size = total_size;
+    header_->magic.store(kShmEnvMagic, std::memory_order_release);
+    return true;
+}
+
+bool ShmEnvRegion::open(const std::string& name, int timeout_ms) {
+    close();
+    name_ = name;
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+
+    // サーバが領域を作成し、サイズを確定するまで待つ
+    int fd = -1;
+    struct stat st = {};
+    while (true) {
+        if (fd == -1) {
+            fd = shm_open(name_.c_str(), O_RDWR, 0600);
+        }
+        if (fd != -1 && fstat(fd, &st) == 0 && st.st_size >= static_cast<off_t>(sizeof(ShmEnvHeader))) {
+            break;
+        }
+        if (std::chrono::steady_clock::now() > deadline) {
+            std::cerr << "[ERROR] Shared memory not available: " << name_ << std::endl;
+            if (fd != -1) {
+                ::close(fd);
+            }
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    void* addr = mmap(nullptr, st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (addr == MAP_FAILED) {
+        std::cerr << "[ERROR] mmap failed: " << name_ << std::endl;
+        return false;
+    }
+    size_ = st.st_size;
+    header_ = static_cast<ShmEnvHeader*>(addr);
+
+    while (header_->magic.load(std::memory_order_acquire) != kShmEnvMagic) {
+        if (std::chrono::steady_clock::now() > deadline) {
+            std::cerr << "[ERROR] Shared memory not initialized: " << name_ << std::endl;
+            close();
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    if (header_->version != kShmEnvVersion || header_->total_size > size_) {
+        std::cerr << "[ERROR] Shared memory layout mismatch: " << name_ << std::endl;
+        close();
+        return false;
+    }
+    return true;
+}
+
+double* ShmEnvRegion::actions() const {
+    return reinterpret_cast<double*>(reinterpret_cast<char*>(header_) + header_->action_offset);
+}
+
+double* ShmEnvRegion::observations() const {
+    return reinterpret_cast<double*>(reinterpret_cast<char*>(header_) + header_->obs_offset);
+}
+
+double* ShmEnvRegion::rewards() const {
+    return reinterpret_cast<double*>(reinterpret_cast<char*>(header_) + header_->reward_offset);
+}
+
+uint8_t* ShmEnvRegion::dones() const {
+    return reinterpret_cast<uint8_t*>(header_) + header_->done_offset;
+}
+
+bool shm_env_wait(ShmEnvSignal* signal, uint32_t old, int timeout_ms) {
+    std::atomic<uint32_t>* seq = &signal->seq;
+    for (int i = 0; i < kSpinCount; i++) {
+        if (seq->load(std::memory_order_acquire) != old) {
+            return true;
+        }
+        cpu_relax();
+    }
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+    while (seq->load(std::memory_order_acquire) == old) {
+        auto now = std::chrono::steady_clock::now();
+        if (timeout_ms >= 0 && now >= deadline) {
+            return false;
+        }
+#if defined(__linux__)
+        // プロセス間で共有するため FUTEX_PRIVATE_FLAG は付けない
+        struct timespec ts;
+        struct timespec* timeout = nullptr;
+        if (timeout_ms >= 0) {
+            auto remaining = std::chrono::duration_cast<std::chrono::nanoseconds>(deadline - now).count();
+            ts.tv_sec = remaining / 1000000000;
+            ts.tv_nsec = remaining % 1000000000;
+            timeout = &ts;
+        }
+        // 眠る前に待機者数を増やし、送信側の seq の更新と waiters の確認の間で起こし損ねないようにする
+        // （ここで seq が変わっていれば、FUTEX_WAIT は値の不一致ですぐに戻る）
+        signal->waiters.fetch_add(1, std::memory_order_seq_cst);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        syscall(SYS_futex, reinterpret_cast<uint32_t*>(seq), FUTEX_WAIT, old, timeout, nullptr, 0);
+        signal->waiters.fetch_sub(1, std::memory_order_relaxed);
+#else
+        std::this_thread::yield();
+#endif
+    }
+    return true;
+}
+
+void shm_env_wake(ShmEnvSignal* signal) {
+#if defined(__linux__)
+    // seq の更新を waiters の読み出しより先に見せる（待機側のフェンスと対になる）
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (signal->waiters.load(std::memory_order_relaxed) != 0) {
+        syscall(SYS_futex, reinterpret_cast<uint32_t*>(&signal->seq), FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+    }
+#else
+    (void)signal;
+#endif
+}
+
+bool shm_env_request(ShmEnvHeader* header, ShmEnvCommand command, int timeout_ms) {
+    header->command = command;
+    uint32_t seq = header->request.seq.fetch_add(1, std::memory_order_release) + 1;
+    shm_env_wake(&header->request);
+
+    uint32_t current = header->response.seq.load(std::memory_order_acquire);
+    while (current != seq) {
+        if (!shm_env_wait(&header->response, current, timeout_ms)) {
+            return false;
+        }
+        current = header->response.seq.load(std::memory_order_acquire);
+    }
+    return true;
+}
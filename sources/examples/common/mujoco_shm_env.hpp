@@ -0,0 +1,123 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * @file mujoco_shm_env.hpp
+ * @brief ベクトル化環境を別プロセスの学習器から駆動するための共有メモリインタフェース
+ *
+ * 共有メモリ上に ShmEnvHeader と、行動・観測・報酬・終了フラグの配列を配置する。
+ * 学習器（クライアント）は行動配列に直接書き込み、request.seq を進めてサーバを起こす。
+ * サーバは VecEnv を1ステップ進め、観測などを共有メモリへ直接書き込んだ後 response.seq を進める。
+ * 待機は短いスピンの後 futex（Linux）で行うため、シリアライズやコピーは発生しない。
+ * 相手が futex で眠っているときだけ FUTEX_WAKE を呼ぶので、スピン中に応答が届く場合はシステムコールが発生しない。
+ * Linux 以外ではスピンと yield による待機になる。
+ */
+
+constexpr uint32_t kShmEnvMagic = 0x4d4a5645;   // "MJVE"
+constexpr uint32_t kShmEnvVersion = 2;
+
+/**
+ * @brief クライアントからサーバへのコマンド
+ */
+enum ShmEnvCommand : uint32_t {
+    kShmEnvStep = 1,      ///< 行動配列を使って全環境を1ステップ進める
+    kShmEnvReset = 2,     ///< 全環境をリセットする
+    kShmEnvShutdown = 3,  ///< サーバを終了する
+};
+
+/**
+ * @brief 片方向の通知（futex の待機対象と、眠っている待機者の数）
+ */
+struct ShmEnvSignal {
+    std::atomic<uint32_t> seq;       ///< 送信側が進める（futex の待機対象）
+    std::atomic<uint32_t> waiters;   ///< futex で眠ろうとしている待機者の数（0 なら FUTEX_WAKE を省く）
+};
+
+/**
+ * @brief 共有メモリ先頭のヘッダ（各配列の位置はヘッダ先頭からのオフセット）
+ */
+struct ShmEnvHeader {
+    std::atomic<uint32_t> magic;          ///< 初期化完了後に kShmEnvMagic が書き込まれる
+    uint32_t version;
+    int32_t num_envs;
+    int32_t nobs;
+    int32_t nu;
+    uint32_t command;                     ///< ShmEnvCommand
+    ShmEnvSignal request;                 ///< クライアントが進める
+    ShmEnvSignal response;                ///< サーバが進める
+    uint64_t action_offset;               ///< double [N x nu]
+    uint64_t obs_offset;                  ///< double [N x nobs]
+    uint64_t reward_offset;               ///< double [N]
+    uint64_t done_offset;                 ///< uint8_t [N]
+    uint64_t total_size;
+};
+
+static_assert(std::atomic<uint32_t>::is_always_lock_free, "futex requires lock-free 32-bit atomics");
+
+/**
+ * @brief 共有メモリ領域（作成または接続）
+ */
+class ShmEnvRegion {
+public:
+    ShmEnvRegion();
+    ~ShmEnvRegion();
+
+    ShmEnvRegion(const ShmEnvRegion&) = delete;
+    ShmEnvRegion& operator=(const ShmEnvRegion&) = delete;
+
+    /**
+     * @brief 共有メモリを作成してレイアウトを初期化する（サーバ側）
+     * @param name 共有メモリ名（"/mujoco_env" など）
+     * @return 成功した場合 true
+     */
+    bool create(const std::string& name, int num_envs, int nobs, int nu);
+
+    /**
+     * @brief 既存の共有メモリに接続する（クライアント側）
+     * @param name 共有メモリ名
+     * @param timeout_ms サーバの初期化完了を待つ時間
+     * @return 成功した場合 true
+     */
+    bool open(const std::string& name, int timeout_ms = 5000);
+
+    ShmEnvHeader* header() const { return header_; }
+    double* actions() const;
+    double* observations() const;
+    double* rewards() const;
+    uint8_t* dones() const;
+
+private:
+    void close();
+
+    std::string name_;
+    bool owner_;
+    size_t size_;
+    ShmEnvHeader* header_;
+};
+
+/**
+ * @brief signal->seq の値が old から変わるまで待つ（スピンの後 futex で待機）
+ * @param signal 待機対象
+ * @param old 現在の値
+ * @param timeout_ms タイムアウト（負の場合は無制限）
+ * @return 変化した場合 true、タイムアウトした場合 false
+ */
+bool shm_env_wait(ShmEnvSignal* signal, uint32_t old, int timeout_ms);
+
+/**
+ * @brief signal->seq を進めた後に呼び、眠っている待機者がいれば起こす
+ */
+void shm_env_wake(ShmEnvSignal* signal);
+
+/**
+ * @brief クライアント: コマンドを送信し、サーバの応答を待つ
+ * @param header 共有メモリのヘッダ
+ * @param command 送信するコマンド
+ * @param timeout_ms 応答を待つ時間（負の場合は無制限）
+ * @return 応答があった場合 true
+ */
+bool shm_env_request(ShmEnvHeader* header, ShmEnvCommand command, int timeout_ms = -1);
@@ -0,0 +1,267 @@
+#include "mujoco_solver_tuner.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <thread>
+#include "mujoco_thread_pool.hpp"
+#include "mujoco_timer.hpp"
+
+namespace {
+
+// 1シナリオの再生結果
+struct ReplayStats {
+    double constraint_us = 0;
+    double step_us = 0;
+    int64_t steps = 0;
+    int64_t solves = 0;
+    int64_t iterations = 0;
+    int64_t saturated = 0;
+    double residual = 0;
+    double drift = 0;
+    bool stable = true;
+};
+
+// シナリオを開ループで再生する
+// - samples: sample_interval ごとの xpos を記録する（基準軌道用）
+// - reference: 基準軌道と比べて最大のずれを stats->drift に書く
+void replay(const mjModel* model, const InputReplay& scenario, int sample_interval, std::vector<mjtNum>* samples,
+            const std::vector<mjtNum>* reference, ReplayStats* stats) {
+    mjData* data = mj_makeData(model);
+    if (!scenario.initial_state(model, data)) {
+        stats->stable = false;
+        mj_deleteData(data);
+        return;
+    }
+    std::memset(data->timer, 0, sizeof(data->timer));
+
+    int width = 3 * model->nbody;
+    size_t sample = 0;
+    for (int64_t step = 0; step < scenario.steps(); step++) {
+        scenario.apply_input(model, data, step);
+        mj_step(model, data);
+
+        int nisland = std::min(std::max(data->solver_nisland, 1), mjNISLAND);
+        for (int island = 0; island < nisland; island++) {
+            int niter = data->solver_niter[island];
+            if (niter <= 0) {
+                continue;
+            }
+            const mjSolverStat& last = data->solver[island * mjNSOLVER + std::min(niter, mjNSOLVER) - 1];
+            stats->solves++;
+            stats->iterations += niter;
+            stats->saturated += niter >= model->opt.iterations;
+            stats->residual += model->opt.solver == mjSOL_PGS ? last.improvement : last.gradient;
+        }
+
+        if ((step + 1) % sample_interval == 0) {
+            for (int i = 0; i < width; i++) {
+                if (!std::isfinite(data->xpos[i])) {
+                    stats->stable = false;
+                }
+            }
+            if (samples) {
+                samples->insert(samples->end(), data->xpos, data->xpos + width);
+            }
+            if (reference && (sample + 1) * width <= reference->size()) {
+                for (int i = 0; i < width; i++) {
+                    stats->drift = std::max(stats->drift, std::fabs(data->xpos[i] - (*reference)[sample * width + i]));
+                }
+            }
+            sample++;
+        }
+        if (!stats->stable || data->warning[mjWARN_BADQACC].number > 0) {
+            stats->stable = false;
+            break;
+        }
+    }
+    stats->steps = scenario.steps();
+    stats->constraint_us = data->timer[mjTIMER_CONSTRAINT].duration;
+    stats->step_us = data->timer[mjTIMER_STEP].duration;
+    mj_deleteData(data);
+}
+
+const char* solver_name(int solver) {
+    switch (solver) {
+    case mjSOL_PGS:
+        return "PGS";
+    case mjSOL_CG:
+        return "CG";
+    default:
+        return "Newton";
+    }
+}
+
+const char* jacobian_name(int jacobian) {
+    switch (jacobian) {
+    case mjJAC_DENSE:
+        return "dense";
+    case mjJAC_SPARSE:
+        return "sparse";
+    default:
+        return "auto";
+    }
+}
+
+}  // namespace
+
+std::string solver_settings_label(const SolverSettings& settings) {
+    std::ostringstream label;
+    label << solver_name(settings.solver) << " it=" << settings.iterations << " tol=" << settings.tolerance;
+    if (settings.solver != mjSOL_PGS) {
+        label << " ls=" << settings.ls_iterations;
+    }
+    label << " " << jacobian_name(settings.jacobian);
+    return label.str();
+}
+
+void apply_solver_settings(mjModel* model, const SolverSettings& settings) {
+    model->opt.solver = settings.solver;
+    model->opt.iterations = settings.iterations;
+    model->opt.tolerance = settings.tolerance;
+    model->opt.ls_iterations = settings.ls_iterations;
+    model->opt.jacobian = settings.jacobian;
+}
+
+std::vector<SolverSettings> make_solver_grid() {
+    std::vector<SolverSettings> grid;
+    for (int solver : {mjSOL_PGS, mjSOL_CG, mjSOL_NEWTON}) {
+        for (int iterations : {5, 10, 20, 50, 100}) {
+            for (double tolerance : {1e-4, 1e-6, 1e-8}) {
+                for (int ls_iterations : {5, 20, 50}) {
+                    if (solver == mjSOL_PGS && ls_iterations != 50) {
+                        continue;
+                    }
+                    for (int jacobian : {mjJAC_DENSE, mjJAC_SPARSE}) {
+                        grid.push_back({solver, iterations, tolerance, ls_iterations, jacobian});
+                    }
+                }
+            }
+        }
+    }
+    return grid;
+}
+
+std::vector<SolverTrialResult> tune_solver(const mjModel* model, const std::vector<const InputReplay*>& scenarios,
+                                           const std::vector<SolverSettings>& grid, const SolverTuneOptions& options) {
+    std::vector<SolverTrialResult> results;
+    enable_mujoco_timers();
+    int nscenario = static_cast<int>(scenarios.size());
+    int ngrid = static_cast<int>(grid.size());
+    int interval = std::max(options.sample_interval, 1);
+    int nworker = options.nworker > 0 ? options.nworker : static_cast<int>(std::thread::hardware_concurrency());
+    WorkerPool pool(std::max(nworker, 1));
+
+    // **基準軌道（シナリオごと）**
+    mjModel* reference_model = mj_copyModel(nullptr, model);
+    apply_solver_settings(reference_model, options.reference);
+    std::vector<std::vector<mjtNum>> references(nscenario);
+    std::vector<ReplayStats> reference_stats(nscenario);
+    pool.parallel_for(nscenario, [&](int, int begin, int end) {
+        for (int s = begin; s < end; s++) {
+            replay(reference_model, *scenarios[s], interval, &references[s], nullptr, &reference_stats[s]);
+        }
+    });
+    mj_deleteModel(reference_model);
+    for (int s = 0; s < nscenario; s++) {
+        if (!reference_stats[s].stable) {
+            std::cerr << "[ERROR] Reference replay of scenario " << s << " failed" << std::endl;
+            return results;
+        }
+    }
+
+    // **設定 x シナリオを並列に再生**
+    std::vector<mjModel*> models(ngrid);
+    for (int g = 0; g < ngrid; g++) {
+        models[g] = mj_copyModel(nullptr, model);
+        apply_solver_settings(models[g], grid[g]);
+    }
+    std::vector<ReplayStats> stats(static_cast<size_t>(ngrid) * nscenario);
+    pool.parallel_for(ngrid * nscenario, [&](int, int begin, int end) {
+        for (int t = begin; t < end; t++) {
+            int g = t / nscenario;
+            int s = t % nscenario;
+            replay(models[g], *scenarios[s], interval, nullptr, &references[s], &stats[t]);
+        }
+    });
+    for (mjModel* m : models) {
+        mj_deleteModel(m);
+    }
+
+    // **設定ごとに集計**
+    results.resize(ngrid);
+    for (int g = 0; g < ngrid; g++) {
+        SolverTrialResult& r = results[g];
+        r.settings = grid[g];
+        int64_t steps = 0, solves = 0, iterations = 0, saturated = 0;
+        double residual = 0;
+        for (int s = 0; s < nscenario; s++) {
+            const ReplayStats& st = stats[static_cast<size_t>(g) * nscenario + s];
+            r.stable = r.stable && st.stable;
+            r.constraint_us += st.constraint_us;
+            r.step_us += st.step_us;
+            r.drift = std::max(r.drift, st.drift);
+            steps += st.steps;
+            solves += st.solves;
+            iterations += st.iterations;
+            saturated += st.saturated;
+            residual += st.residual;
+        }
+        if (steps > 0) {
+            r.constraint_us /= steps;
+            r.step_us /= steps;
+        }
+        if (solves > 0) {
+            r.mean_iterations = static_cast<double>(iterations) / solves;
+            r.saturated = static_cast<double>(saturated) / solves;
+            r.mean_residual = residual / solves;
+        }
+        if (!r.stable) {
+            r.drift = INFINITY;
+        }
+    }
+    return results;
+}
+
+const SolverTrialResult* recommend_solver(const std::vector<SolverTrialResult>& results, double drift_tolerance) {
+    const SolverTrialResult* best = nullptr;
+    for (const SolverTrialResult& r : results) {
+        if (r.stable && r.drift <= drift_tolerance && (!best || r.constraint_us < best->constraint_us)) {
+            best = &r;
+        }
+    }
+    return best;
+}
+
+void print_solver_table(const std::vector<SolverTrialResult>& results, std::ostream& out, int max_rows) {
+    std::vector<const SolverTrialResult*> sorted;
+    for (const SolverTrialResult& r : results) {
+        sorted.push_back(&r);
+    }
+    std::sort(sorted.begin(), sorted.end(), [](const SolverTrialResult* a, const SolverTrialResult* b) {
+        return a->constraint_us < b->constraint_us;
+    });
+
+    out << std::left << std::setw(40) << "settings" << std::right << std::setw(12) << "constr [us]"
+        << std::setw(10) << "step [us]" << std::setw(8) << "iter" << std::setw(8) << "sat%" << std::setw(12)
+        << "residual" << std::setw(12) << "drift [m]" << std::endl;
+    int rows = 0;
+    for (const SolverTrialResult* r : sorted) {
+        if (rows++ >= max_rows) {
+            break;
+        }
+        out << std::left << std::setw(40) << solver_settings_label(r->settings) << std::right << std::fixed
+            << std::setprecision(2) << std::setw(12) << r->constraint_us << std::setw(10) << r->step_us
+            << std::setprecision(1) << std::setw(8) << r->mean_iterations << std::setw(8) << 100.0 * r->saturated
+            << std::scientific << std::setprecision(2) << std::setw(12) << r->mean_residual;
+        if (r->stable) {
+            out << std::setw(12) << r->drift;
+        } else {
+            out << std::setw(12) << "diverged";
+        }
+        out << std::defaultfloat << std::setprecision(6) << std::endl;
+    }
+}
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <mujoco/mujoco.h>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "mujoco_input_recorder.hpp"
+
+/**
+ * @file mujoco_solver_tuner.hpp
+ * @brief 制約ソルバの設定（solver / iterations / tolerance / ls_iterations / jacobian）の自動調整
+ *
+ * InputRecorder で記録したシナリオを、設定の格子の各点で開ループ再生し（WorkerPool で並列実行）、
+ * 次を測る。
+ * - `mjTIMER_CONSTRAINT` による1ステップあたりの制約計算時間
+ * - `mjData::solver` の最終反復の残差（CG / Newton は gradient、PGS は improvement）と反復回数
+ * - 高精度の基準設定で再生した軌道からの全ボディ位置のずれ（ドリフト）
+ * ドリフトが許容値以内の設定のうち、制約計算時間が最小のものを推奨する。
+ *
+ * @note 計測は並列に行うため、ワーカー数が物理コア数を超えると時間の比較が不正確になる。
+ */
+
+/**
+ * @brief ソルバ設定
+ */
+struct SolverSettings {
+    int solver = mjSOL_NEWTON;      ///< mjSOL_*
+    int iterations = 100;
+    double tolerance = 1e-8;
+    int ls_iterations = 50;
+    int jacobian = mjJAC_AUTO;      ///< mjJAC_*
+};
+
+/**
+ * @brief 1つの設定の計測結果（全シナリオの集計）
+ */
+struct SolverTrialResult {
+    SolverSettings settings;
+    double constraint_us = 0;       ///< 1ステップあたりの mjTIMER_CONSTRAINT [us]
+    double step_us = 0;             ///< 1ステップあたりの mjTIMER_STEP [us]
+    double mean_iterations = 0;     ///< 1ステップあたりの平均反復回数
+    double saturated = 0;           ///< 反復回数が上限に達したステップの割合
+    double mean_residual = 0;       ///< 最終反復の残差の平均
+    double drift = 0;               ///< 基準軌道からの最大位置ずれ [m]
+    bool stable = true;
+};
+
+/**
+ * @brief 調整の設定
+ */
+struct SolverTuneOptions {
+    SolverSettings reference = {mjSOL_NEWTON, 1000, 1e-12, 100, mjJAC_DENSE};  ///< 基準軌道の設定
+    int sample_interval = 10;       ///< ドリフトを比べるステップ間隔
+    int nworker = 0;                ///< ワーカー数（0 でハードウェアスレッド数）
+};
+
+/**
+ * @brief 設定の表記（"Newton it=100 tol=1e-08 ls=50 dense" など）
+ */
+std::string solver_settings_label(const SolverSettings& settings);
+
+/**
+ * @brief 設定をモデルに書き込む
+ */
+void apply_solver_settings(mjModel* model, const SolverSettings& settings);
+
+/**
+ * @brief 既定の探索格子（PGS では ls_iterations を変えない）
+ */
+std::vector<SolverSettings> make_solver_grid();
+
+/**
+ * @brief 記録したシナリオを全設定で再生して計測する
+ * @param model MuJoCoのモデルデータ（変更しない）
+ * @param scenarios 記録したシナリオ（モデルと次元が一致するもの）
+ * @param grid 試す設定
+ * @param options 設定
+ * @return 設定ごとの結果（grid と同じ順）、基準軌道が作れなかった場合は空
+ */
+std::vector<SolverTrialResult> tune_solver(const mjModel* model, const std::vector<const InputReplay*>& scenarios,
+                                           const std::vector<SolverSettings>& grid,
+                                           const SolverTuneOptions& options = SolverTuneOptions());
+
+/**
+ * @brief ドリフトが許容値以内で制約計算時間が最小の設定
+ * @return 見つからない場合 nullptr
+ */
+const SolverTrialResult* recommend_solver(const std::vector<SolverTrialResult>& results, double drift_tolerance);
+
+/**
+ * @brief 結果を制約計算時間の順に出力する（上位 max_rows 件）
+ */
+void print_solver_table(const std::vector<SolverTrialResult>& results, std::ostream& out, int max_rows = 20);
@@ -0,0 +1,41 @@
+#include "mujoco_state_hash.hpp"
+#include <cstring>
+
+namespace {
+
+// murmur3 の fmix64（全ビットを全ビットへ拡散する）
+uint64_t fmix64(uint64_t k) {
+    k ^= k >> 33;
+    k *= 0xff51afd7ed558ccdULL;
+    k ^= k >> 33;
+    k *= 0xc4ceb9fe1a85ec53ULL;
+    k ^= k >> 33;
+    return k;
+}
+
+uint64_t rotl64(uint64_t x, int r) {
+    return (x << r) | (x >> (64 - r));
+}
+
+}  // namespace
+
+uint64_t hash_state(const mjtNum* state, int size) {
+    // 各ワードを fmix64 で拡散してから回転・乗算で累積する
+    // （XOR と乗算だけでは最上位ビット（符号）の差が下位へ伝わらず、符号の反転2つが打ち消し合う）
+    uint64_t hash = 0x9e3779b97f4a7c15ULL;
+    for (int i = 0; i < size; i++) {
+        uint64_t bits;
+        std::memcpy(&bits, &state[i], sizeof(bits));
+        hash ^= fmix64(bits + 0x9e3779b97f4a7c15ULL * static_cast<uint64_t>(i + 1));
+        hash = rotl64(hash, 27) * 0x87c37b91114253d5ULL + 0x52dce729ULL;
+    }
+    return fmix64(hash ^ static_cast<uint64_t>(size));
+}
+
+StateHasher::StateHasher(const mjModel* model, unsigned int spec)
+    : model_(model), spec_(spec), state_(mj_stateSize(model, spec)) {}
+
+uint64_t StateHasher::hash(const mjData* data) {
+    mj_getState(model_, data, state_.data(), spec_);
+    return hash_state(state_.data(), static_cast<int>(state_.size()));
+}
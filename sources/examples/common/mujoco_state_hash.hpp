@@ -0,0 +1,51 @@
+#pragma once
+
+#include <mujoco/mujoco.h>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @file mujoco_state_hash.hpp
+ * @brief シミュレーション状態の64ビットハッシュ
+ *
+ * `mj_getState` で取り出した状態ベクトルのビット列をそのままハッシュする。
+ * 各ワードを 64ビットのミキサー（murmur3 の fmix64）に通してから累積するため、
+ * 値が1ビットでも異なれば（-0.0 と 0.0、符号の入れ替わりも区別して）ほぼ確実に別のハッシュになり、
+ * 再シミュレーションや並列実行の結果がビット単位で一致するかの確認に使う。
+ */
+
+/**
+ * @brief 状態ベクトルのハッシュ（ワードごとに fmix64 で拡散し、回転・乗算で累積する）
+ * @param state 状態ベクトル
+ * @param size 要素数
+ */
+uint64_t hash_state(const mjtNum* state, int size);
+
+/**
+ * @brief mjData の状態をハッシュする（作業領域を使い回す）
+ */
+class StateHasher {
+public:
+    /**
+     * @param model MuJoCoのモデルデータ
+     * @param spec ハッシュする状態の種類（mjtState のビット和）
+     */
+    explicit StateHasher(const mjModel* model, unsigned int spec = mjSTATE_INTEGRATION);
+
+    /**
+     * @brief 現在の状態のハッシュ
+     */
+    uint64_t hash(const mjData* data);
+
+    /**
+     * @brief 直前に hash() したときの状態ベクトル
+     */
+    const std::vector<mjtNum>& state() const { return state_; }
+
+    unsigned int spec() const { return spec_; }
+
+private:
+    const mjModel* model_;
+    unsigned int spec_;
+    std::vector<mjtNum> state_;
+};
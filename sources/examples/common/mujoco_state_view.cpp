@@ -0,0 +1,26 @@
+#include "mujoco_state_view.hpp"
+#include <iostream>
+
+int joint_qpos_size(int type) {
+    switch (type) {
+        case mjJNT_FREE: return 7;
+        case mjJNT_BALL: return 4;
+        default: return 1;
+    }
+}
+
+int joint_dof_size(int type) {
+    switch (type) {
+        case mjJNT_FREE: return 6;
+        case mjJNT_BALL: return 3;
+        default: return 1;
+    }
+}
+
+int resolve_object_id(const mjModel* model, mjtObj type, const std::string& name) {
+    int id = mj_name2id(model, type, name.c_str());
+    if (id == -1) {
+        std::cerr << "[ERROR] " << mju_type2Str(type) << " not found: " << name << std::endl;
+    }
+    return id;
+}
@@ -0,0 +1,277 @@
+#pragma once
+
+#include <mujoco/mujoco.h>
+#include <string>
+#include <type_traits>
+
+/**
+ * @file mujoco_state_view.hpp
+ * @brief mjData の配列を指す型付きビュー（関節・剛体・アクチュエータ）
+ *
+ * 名前解決とアドレス計算（`jnt_qposadr` / `jnt_dofadr` など）は bind 時に1回だけ行い、
+ * 以降は mjData の配列を直接指すスパンとして読み書きする。毎ステップの名前検索や
+ * 関節の種類による分岐が不要になる。
+ *
+ * - `JointView` / `BodyView` / `ActuatorView` は書き込み可能な mjData* に、
+ *   `ConstJointView` などは const mjData* に束縛する
+ * - `BodyBatchView` は連続した剛体範囲を成分ごとのストライド付きスパン（SoA）として見せる
+ *
+ * @note ビューは mjData の配列を指すため、mj_recompile などで mjData が再確保された場合は bind し直すこと
+ */
+
+/**
+ * @brief 関節の qpos 要素数（free:7, ball:4, slide/hinge:1）
+ */
+int joint_qpos_size(int type);
+
+/**
+ * @brief 関節の自由度（qvel 要素数）（free:6, ball:3, slide/hinge:1）
+ */
+int joint_dof_size(int type);
+
+/**
+ * @brief 名前から ID を取得する（見つからない場合はエラーを出力して -1）
+ */
+int resolve_object_id(const mjModel* model, mjtObj type, const std::string& name);
+
+/**
+ * @brief 連続領域を指すスパン
+ */
+template <typename T>
+class StateSpan {
+public:
+    StateSpan() : data_(nullptr), size_(0) {}
+    StateSpan(T* data, int size) : data_(data), size_(size) {}
+
+    T* data() const { return data_; }
+    int size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    T& operator[](int i) const { return data_[i]; }
+    T* begin() const { return data_; }
+    T* end() const { return data_ + size_; }
+
+private:
+    T* data_;
+    int size_;
+};
+
+/**
+ * @brief 一定間隔で並んだ要素を指すスパン（AoS 配列の1成分を SoA として扱う）
+ */
+template <typename T>
+class StridedSpan {
+public:
+    StridedSpan() : data_(nullptr), stride_(0), size_(0) {}
+    StridedSpan(T* data, int stride, int size) : data_(data), stride_(stride), size_(size) {}
+
+    T* data() const { return data_; }
+    int stride() const { return stride_; }
+    int size() const { return size_; }
+    T& operator[](int i) const { return data_[i * stride_]; }
+
+private:
+    T* data_;
+    int stride_;
+    int size_;
+};
+
+namespace state_view_detail {
+// 要素型が const なら const mjData* に束縛する
+template <typename T>
+using DataPtr = typename std::conditional<std::is_const<T>::value, const mjData*, mjData*>::type;
+}  // namespace state_view_detail
+
+/**
+ * @brief 関節のビュー（qpos / qvel）
+ */
+template <typename T>
+class BasicJointView {
+public:
+    using DataPtr = state_view_detail::DataPtr<T>;
+
+    BasicJointView() : id_(-1), type_(mjJNT_HINGE) {}
+
+    /**
+     * @brief 名前で関節を解決して束縛する
+     * @return 見つからない場合は無効なビュー（valid() == false）
+     */
+    static BasicJointView bind(const mjModel* model, DataPtr data, const std::string& name) {
+        return bind(model, data, resolve_object_id(model, mjOBJ_JOINT, name));
+    }
+
+    /**
+     * @brief ID で関節を束縛する
+     */
+    static BasicJointView bind(const mjModel* model, DataPtr data, int id) {
+        BasicJointView view;
+        if (id < 0 || id >= model->njnt) {
+            return view;
+        }
+        view.id_ = id;
+        view.type_ = model->jnt_type[id];
+        view.qpos_ = StateSpan<T>(data->qpos + model->jnt_qposadr[id], joint_qpos_size(view.type_));
+        view.qvel_ = StateSpan<T>(data->qvel + model->jnt_dofadr[id], joint_dof_size(view.type_));
+        return view;
+    }
+
+    bool valid() const { return id_ != -1; }
+    int id() const { return id_; }
+    int type() const { return type_; }
+
+    /**
+     * @brief 関節の位置（free: pos(3)+quat(4), ball: quat(4), hinge/slide: 1）
+     */
+    StateSpan<T> qpos() const { return qpos_; }
+
+    /**
+     * @brief 関節の速度（free: 並進(3)+回転(3), ball: 3, hinge/slide: 1）
+     */
+    StateSpan<T> qvel() const { return qvel_; }
+
+private:
+    int id_;
+    int type_;
+    StateSpan<T> qpos_;
+    StateSpan<T> qvel_;
+};
+
+/**
+ * @brief 剛体のビュー（ワールド座標の位置・姿勢）
+ */
+template <typename T>
+class BasicBodyView {
+public:
+    using DataPtr = state_view_detail::DataPtr<T>;
+
+    BasicBodyView() : id_(-1), xpos_(nullptr), xquat_(nullptr), xmat_(nullptr) {}
+
+    static BasicBodyView bind(const mjModel* model, DataPtr data, const std::string& name) {
+        return bind(model, data, resolve_object_id(model, mjOBJ_BODY, name));
+    }
+
+    static BasicBodyView bind(const mjModel* model, DataPtr data, int id) {
+        BasicBodyView view;
+        if (id < 0 || id >= model->nbody) {
+            return view;
+        }
+        view.id_ = id;
+        view.xpos_ = data->xpos + 3 * id;
+        view.xquat_ = data->xquat + 4 * id;
+        view.xmat_ = data->xmat + 9 * id;
+        return view;
+    }
+
+    bool valid() const { return id_ != -1; }
+    int id() const { return id_; }
+
+    /** @brief ワールド座標の位置 [3] */
+    T* xpos() const { return xpos_; }
+    /** @brief ワールド座標の姿勢クォータニオン [4] (w, x, y, z) */
+    T* xquat() const { return xquat_; }
+    /** @brief ワールド座標の回転行列 [9]（行優先） */
+    T* xmat() const { return xmat_; }
+
+private:
+    int id_;
+    T* xpos_;
+    T* xquat_;
+    T* xmat_;
+};
+
+/**
+ * @brief アクチュエータのビュー（制御入力・出力）
+ */
+template <typename T>
+class BasicActuatorView {
+public:
+    using DataPtr = state_view_detail::DataPtr<T>;
+
+    BasicActuatorView() : id_(-1), ctrl_(nullptr), force_(nullptr), ctrlrange_(nullptr) {}
+
+    static BasicActuatorView bind(const mjModel* model, DataPtr data, const std::string& name) {
+        return bind(model, data, resolve_object_id(model, mjOBJ_ACTUATOR, name));
+    }
+
+    static BasicActuatorView bind(const mjModel* model, DataPtr data, int id) {
+        BasicActuatorView view;
+        if (id < 0 || id >= model->nu) {
+            return view;
+        }
+        view.id_ = id;
+        view.ctrl_ = data->ctrl + id;
+        view.force_ = data->actuator_force + id;
+        view.ctrlrange_ = model->actuator_ctrlrange + 2 * id;
+        return view;
+    }
+
+    bool valid() const { return id_ != -1; }
+    int id() const { return id_; }
+
+    /** @brief 制御入力 */
+    T& ctrl() const { return *ctrl_; }
+    /** @brief アクチュエータ出力 */
+    const mjtNum& force() const { return *force_; }
+    /** @brief 制御範囲 [2] (min, max) */
+    const mjtNum* ctrlrange() const { return ctrlrange_; }
+
+private:
+    int id_;
+    T* ctrl_;
+    const mjtNum* force_;
+    const mjtNum* ctrlrange_;
+};
+
+/**
+ * @brief 連続した剛体範囲 [first, first + count) のバッチビュー
+ *
+ * `xpos` / `xquat` は剛体ごとに成分が並ぶ AoS 配列なので、成分ごとのストライド付きスパンとして
+ * 取り出す。`x()[i]` は剛体 first + i の x 座標を指す。
+ */
+template <typename T>
+class BasicBodyBatchView {
+public:
+    using DataPtr = state_view_detail::DataPtr<T>;
+
+    BasicBodyBatchView() : first_(0), count_(0), xpos_(nullptr), xquat_(nullptr) {}
+
+    static BasicBodyBatchView bind(const mjModel* model, DataPtr data, int first, int count) {
+        BasicBodyBatchView view;
+        if (first < 0 || count < 0 || first + count > model->nbody) {
+            return view;
+        }
+        view.first_ = first;
+        view.count_ = count;
+        view.xpos_ = data->xpos + 3 * first;
+        view.xquat_ = data->xquat + 4 * first;
+        return view;
+    }
+
+    int first() const { return first_; }
+    int count() const { return count_; }
+
+    /** @brief 位置の成分 axis (0:x, 1:y, 2:z) */
+    StridedSpan<T> xpos(int axis) const { return StridedSpan<T>(xpos_ + axis, 3, count_); }
+    /** @brief クォータニオンの成分 k (0:w, 1:x, 2:y, 3:z) */
+    StridedSpan<T> xquat(int k) const { return StridedSpan<T>(xquat_ + k, 4, count_); }
+    /** @brief 連続した xquat 配列 [4 * count] */
+    T* xquat_data() const { return xquat_; }
+
+    StridedSpan<T> x() const { return xpos(0); }
+    StridedSpan<T> y() const { return xpos(1); }
+    StridedSpan<T> z() const { return xpos(2); }
+
+private:
+    int first_;
+    int count_;
+    T* xpos_;
+    T* xquat_;
+};
+
+using JointView = BasicJointView<mjtNum>;
+using ConstJointView = BasicJointView<const mjtNum>;
+using BodyView = BasicBodyView<mjtNum>;
+using ConstBodyView = BasicBodyView<const mjtNum>;
+using ActuatorView = BasicActuatorView<mjtNum>;
+using ConstActuatorView = BasicActuatorView<const mjtNum>;
+using BodyBatchView = BasicBodyBatchView<mjtNum>;
+using ConstBodyBatchView = BasicBodyBatchView<const mjtNum>;
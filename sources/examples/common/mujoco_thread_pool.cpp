@@ -0,0 +1,68 @@
+#include "mujoco_thread_pool.hpp"
+#include <algorithm>
+#include <vector>
+
+namespace {
+
+struct ChunkArgs {
+    const std::function<void(int, int, int)>* fn;
+    int worker;
+    int begin;
+    int end;
+};
+
+void* run_chunk(void* arg) {
+    ChunkArgs* chunk = static_cast<ChunkArgs*>(arg);
+    (*chunk->fn)(chunk->worker, chunk->begin, chunk->end);
+    return nullptr;
+}
+
+}  // namespace
+
+WorkerPool::WorkerPool(int nworker)
+    : nworker_(std::max(1, std::min(nworker, mjMAXTHREAD))), pool_(nullptr) {
+    if (nworker_ > 1) {
+        pool_ = mju_threadPoolCreate(nworker_ - 1);
+    }
+}
+
+WorkerPool::~WorkerPool() {
+    if (pool_) {
+        mju_threadPoolDestroy(pool_);
+    }
+}
+
+void WorkerPool::parallel_for(int n, const std::function<void(int worker, int begin, int end)>& fn) {
+    if (n <= 0) {
+        return;
+    }
+    int nchunk = std::min(nworker_, n);
+    if (nchunk == 1 || !pool_) {
+        fn(0, 0, n);
+        return;
+    }
+
+    // 要素数をチャンクへ均等に割り振る（端数は先頭のチャンクへ）
+    std::vector<ChunkArgs> args(nchunk);
+    int base = n / nchunk;
+    int rest = n % nchunk;
+    int begin = 0;
+    for (int i = 0; i < nchunk; i++) {
+        int count = base + (i < rest ? 1 : 0);
+        args[i] = {&fn, i, begin, begin + count};
+        begin += count;
+    }
+
+    // チャンク0以外をプールへ投入し、チャンク0は呼び出しスレッドで実行する
+    std::vector<mjTask> tasks(nchunk);
+    for (int i = 1; i < nchunk; i++) {
+        mju_defaultTask(&tasks[i]);
+        tasks[i].func = run_chunk;
+        tasks[i].args = &args[i];
+        mju_threadPoolEnqueue(pool_, &tasks[i]);
+    }
+    run_chunk(&args[0]);
+    for (int i = 1; i < nchunk; i++) {
+        mju_taskJoin(&tasks[i]);
+    }
+}
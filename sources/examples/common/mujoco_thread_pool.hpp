@@ -0,0 +1,46 @@
+#pragma once
+
+#include <mujoco/mujoco.h>
+#include <functional>
+
+/**
+ * @file mujoco_thread_pool.hpp
+ * @brief MuJoCoのスレッドプール (`mjThreadPool`) を使った並列実行ヘルパー
+ *
+ * 処理範囲をワーカー数のチャンクに分割して実行する。
+ * チャンク番号はワーカー専用の `mjData` などを選ぶ添字として使える。
+ * チャンク0は呼び出しスレッドで実行するため、内部のプールは `nworker - 1` スレッドとなる。
+ */
+class WorkerPool {
+public:
+    /**
+     * @brief スレッドプールを生成する
+     * @param nworker ワーカー数（1以下の場合はプールを作らず呼び出しスレッドで逐次実行）
+     */
+    explicit WorkerPool(int nworker);
+    ~WorkerPool();
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    /**
+     * @brief ワーカー数（呼び出しスレッドを含む）
+     */
+    int size() const { return nworker_; }
+
+    /**
+     * @brief 内部の `mjThreadPool`（`mju_bindThreadPool` 用、逐次実行時は nullptr）
+     */
+    mjThreadPool* handle() const { return pool_; }
+
+    /**
+     * @brief [0, n) をワーカー数のチャンクに分割して並列実行し、全チャンクの完了を待つ
+     * @param n 処理対象の要素数
+     * @param fn fn(worker, begin, end) を各チャンクで呼び出す
+     */
+    void parallel_for(int n, const std::function<void(int worker, int begin, int end)>& fn);
+
+private:
+    int nworker_;
+    mjThreadPool* pool_;
+};
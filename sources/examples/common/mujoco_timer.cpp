@@ -0,0 +1,22 @@
+#include "mujoco_timer.hpp"
+#include <chrono>
+
+namespace {
+
+mjtNum steady_clock_us() {
+    using namespace std::chrono;
+    return duration<double, std::micro>(steady_clock::now().time_since_epoch()).count();
+}
+
+}  // namespace
+
+void enable_mujoco_timers() {
+    if (!mjcb_time) {
+        mjcb_time = steady_clock_us;
+    }
+}
+
+double mujoco_timer_average_us(const mjData* data, int timer) {
+    const mjTimerStat& stat = data->timer[timer];
+    return stat.number > 0 ? stat.duration / stat.number : 0.0;
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <mujoco/mujoco.h>
+
+/**
+ * @file mujoco_timer.hpp
+ * @brief MuJoCo 内部タイマー (`mjData::timer`) の有効化
+ *
+ * MuJoCo は `mjcb_time` が設定されている場合だけ mjTIMER_* の区間を計測する。
+ * ここでは std::chrono::steady_clock をマイクロ秒単位で返すコールバックを設定する。
+ */
+
+/**
+ * @brief mjcb_time が未設定なら steady_clock [us] を設定する（以降 timer[].duration はマイクロ秒）
+ */
+void enable_mujoco_timers();
+
+/**
+ * @brief タイマーの1回あたりの平均時間 [us]（1度も呼ばれていない場合 0）
+ */
+double mujoco_timer_average_us(const mjData* data, int timer);
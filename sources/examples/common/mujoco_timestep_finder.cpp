@@ -0,0 +1,171 @@
+#include "mujoco_timestep_finder.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <thread>
+#include "mujoco_thread_pool.hpp"
+
+namespace {
+
+// 1回の試行（エネルギーの絶対値の最大を max_energy に書く）
+bool run_trial(const mjModel* model, const ControlProfile& profile, double duration, double energy_limit,
+               double* max_energy) {
+    mjData* data = mj_makeData(model);
+    mj_forward(model, data);
+    int64_t steps = static_cast<int64_t>(std::ceil(duration / model->opt.timestep));
+    bool stable = true;
+    double peak = 0;
+    for (int64_t i = 0; i < steps && stable; i++) {
+        if (profile.ctrl) {
+            profile.ctrl(model, data, data->ctrl);
+        }
+        mj_step(model, data);
+        if (data->warning[mjWARN_BADQACC].number > 0 || data->warning[mjWARN_BADQVEL].number > 0 ||
+            data->warning[mjWARN_BADQPOS].number > 0) {
+            stable = false;
+            break;
+        }
+        double energy = std::fabs(data->energy[0] + data->energy[1]);
+        if (!std::isfinite(energy) || energy > energy_limit) {
+            stable = false;
+        }
+        peak = std::max(peak, energy);
+    }
+    for (int i = 0; i < model->nq && stable; i++) {
+        stable = std::isfinite(data->qpos[i]);
+    }
+    mj_deleteData(data);
+    if (max_energy) {
+        *max_energy = peak;
+    }
+    return stable;
+}
+
+mjModel* copy_with_timestep(const mjModel* model, double timestep) {
+    mjModel* m = mj_copyModel(nullptr, model);
+    m->opt.timestep = timestep;
+    m->opt.enableflags |= mjENBL_ENERGY;
+    return m;
+}
+
+}  // namespace
+
+TimestepSearchResult find_stable_timestep(const mjModel* model, const std::vector<ControlProfile>& profiles,
+                                          const TimestepSearchOptions& options) {
+    TimestepSearchResult result;
+    int nprofile = static_cast<int>(profiles.size());
+    int nworker = options.nworker > 0 ? options.nworker : static_cast<int>(std::thread::hardware_concurrency());
+    WorkerPool pool(std::max(nworker, 1));
+
+    // candidates x profiles の試行をまとめて並列に走らせ、候補ごとに最初に不安定だったプロファイルを返す（-1 は安定）
+    std::vector<double> limits(nprofile, INFINITY);
+    std::vector<double> peaks;
+    auto run_round = [&](const std::vector<double>& candidates) {
+        int ncandidate = static_cast<int>(candidates.size());
+        std::vector<mjModel*> models(ncandidate);
+        for (int c = 0; c < ncandidate; c++) {
+            models[c] = copy_with_timestep(model, candidates[c]);
+        }
+        int ntrial = ncandidate * nprofile;
+        std::vector<char> stable(ntrial, 1);
+        peaks.assign(ntrial, 0);
+        pool.parallel_for(ntrial, [&](int, int begin, int end) {
+            for (int t = begin; t < end; t++) {
+                int c = t / nprofile;
+                int p = t % nprofile;
+                stable[t] = run_trial(models[c], profiles[p], options.duration, limits[p], &peaks[t]);
+            }
+        });
+        result.trials += ntrial;
+        for (mjModel* m : models) {
+            mj_deleteModel(m);
+        }
+        std::vector<int> failed(ncandidate, -1);
+        for (int t = ntrial - 1; t >= 0; t--) {
+            if (!stable[t]) {
+                failed[t / nprofile] = t % nprofile;
+            }
+        }
+        return failed;
+    };
+
+    // **基準: 最小の timestep で全プロファイルを走らせ、エネルギーの上限を決める**
+    std::vector<int> failed = run_round({options.min_timestep});
+    if (failed[0] >= 0) {
+        std::cerr << "[ERROR] Profile '" << profiles[failed[0]].name << "' is unstable even at timestep "
+                  << options.min_timestep << std::endl;
+        result.failed_profile = profiles[failed[0]].name;
+        result.unstable_timestep = options.min_timestep;
+        return result;
+    }
+    for (int p = 0; p < nprofile; p++) {
+        limits[p] = options.energy_factor * peaks[p] + options.energy_margin;
+    }
+    result.found = true;
+
+    // **上限がそのまま安定なら終了**
+    double lo = options.min_timestep;
+    double hi = options.max_timestep;
+    failed = run_round({hi});
+    if (failed[0] < 0) {
+        result.timestep = hi;
+        return result;
+    }
+    result.unstable_timestep = hi;
+    result.failed_profile = profiles[failed[0]].name;
+
+    // **[lo, hi) を対数スケールで分割して挟み込む**
+    int ncandidate = std::max(1, pool.size() / std::max(nprofile, 1));
+    while (hi / lo - 1.0 > options.tolerance) {
+        std::vector<double> candidates(ncandidate);
+        for (int k = 0; k < ncandidate; k++) {
+            candidates[k] = lo * std::pow(hi / lo, static_cast<double>(k + 1) / (ncandidate + 1));
+        }
+        failed = run_round(candidates);
+        // 最初に不安定になった候補の手前までを安定とみなす
+        int first = ncandidate;
+        for (int k = 0; k < ncandidate; k++) {
+            if (failed[k] >= 0) {
+                first = k;
+                break;
+            }
+        }
+        if (first < ncandidate) {
+            hi = candidates[first];
+            result.unstable_timestep = hi;
+            result.failed_profile = profiles[failed[first]].name;
+        }
+        if (first > 0) {
+            lo = candidates[first - 1];
+        }
+        std::cout << "[INFO] Timestep search: stable " << lo << ", unstable " << hi << std::endl;
+    }
+    result.timestep = lo;
+    return result;
+}
+
+bool write_timestep(const std::string& xml_path, const std::string& out_path, double timestep) {
+    char error[1000];
+    mjSpec* spec = mj_parseXML(xml_path.c_str(), nullptr, error, sizeof(error));
+    if (!spec) {
+        std::cerr << "[ERROR] Failed to parse model: " << xml_path << "\n" << error << std::endl;
+        return false;
+    }
+    spec->option.timestep = timestep;
+
+    // mj_saveXML はコンパイル済みの mjSpec を要求する
+    mjModel* model = mj_compile(spec, nullptr);
+    bool ok = model != nullptr;
+    if (!ok) {
+        std::cerr << "[ERROR] Failed to compile model: " << xml_path << "\n" << mjs_getError(spec) << std::endl;
+    } else if (mj_saveXML(spec, out_path.c_str(), error, sizeof(error)) != 0) {
+        std::cerr << "[ERROR] Failed to save model: " << out_path << "\n" << error << std::endl;
+        ok = false;
+    }
+    if (model) {
+        mj_deleteModel(model);
+    }
+    mj_deleteSpec(spec);
+    return ok;
+}
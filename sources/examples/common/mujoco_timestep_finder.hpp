@@ -0,0 +1,70 @@
+#pragma once
+
+#include <mujoco/mujoco.h>
+#include <string>
+#include <vector>
+#include "mujoco_integrator_sweep.hpp"
+
+/**
+ * @file mujoco_timestep_finder.hpp
+ * @brief 制御プロファイルの全てで安定に動く最大の timestep を探す
+ *
+ * 各 timestep 候補で全プロファイルの試行シミュレーションを並列に走らせ、次のいずれかで不安定と判定する。
+ * - NaN / Inf、または MuJoCo の BADQPOS / BADQVEL / BADQACC 警告
+ * - 全エネルギー（mjENBL_ENERGY の位置 + 運動エネルギー）の絶対値が、
+ *   最小 timestep で走らせた基準の最大値を大きく超える（数値的なエネルギーの湧き出し）
+ *
+ * 探索は対数スケールの多分割法（二分法を並列化したもの）で、
+ * 1ラウンドでワーカー数に応じた複数の候補をまとめて試し、安定・不安定の境界を挟み込む。
+ */
+
+/**
+ * @brief 試行に使う制御プロファイル
+ */
+struct ControlProfile {
+    std::string name;
+    SweepCtrlFn ctrl;
+};
+
+/**
+ * @brief 探索の設定
+ */
+struct TimestepSearchOptions {
+    double duration = 10.0;         ///< 試行1回のシミュレーション時間 [s]
+    double min_timestep = 1e-4;     ///< 探索範囲の下限（基準の試行にも使う）[s]
+    double max_timestep = 0.05;     ///< 探索範囲の上限 [s]
+    double tolerance = 0.02;        ///< 探索を終える区間の幅（上限/下限 - 1）
+    double energy_factor = 2.0;     ///< 基準の最大エネルギーに対して許す倍率
+    double energy_margin = 1.0;     ///< 基準の最大エネルギーに加えて許す絶対値 [J]（静止状態など 0 付近の場合用）
+    int nworker = 0;                ///< ワーカー数（0 でハードウェアスレッド数）
+};
+
+/**
+ * @brief 探索結果
+ */
+struct TimestepSearchResult {
+    bool found = false;             ///< min_timestep で全プロファイルが安定した場合 true
+    double timestep = 0;            ///< 安定を確認できた最大の timestep
+    double unstable_timestep = 0;   ///< 不安定を確認した最小の timestep（上限まで安定なら 0）
+    std::string failed_profile;     ///< unstable_timestep で最初に不安定になったプロファイル
+    int trials = 0;                 ///< 走らせた試行の総数
+};
+
+/**
+ * @brief 安定な最大の timestep を探す
+ * @param model MuJoCoのモデルデータ（変更しない。積分器などはモデルの設定のまま）
+ * @param profiles 制御プロファイル（ctrl は複数スレッドから同時に呼ばれる）
+ * @param options 設定
+ * @return 探索結果
+ */
+TimestepSearchResult find_stable_timestep(const mjModel* model, const std::vector<ControlProfile>& profiles,
+                                          const TimestepSearchOptions& options = TimestepSearchOptions());
+
+/**
+ * @brief MJCF の opt.timestep を書き換えて保存する（mjSpec 経由）
+ * @param xml_path 元の MJCF
+ * @param out_path 出力先（元と同じでもよいが、コメントは失われる）
+ * @param timestep 書き込む timestep [s]
+ * @return 成功した場合 true
+ */
+bool write_timestep(const std::string& xml_path, const std::string& out_path, double timestep);
@@ -0,0 +1,60 @@
+#include "mujoco_variant_builder.hpp"
+#include <atomic>
+#include <iostream>
+#include <mutex>
+
+VariantBuilder::VariantBuilder(int nworker) : pool_(nworker), base_(nullptr) {}
+
+VariantBuilder::~VariantBuilder() {
+    if (base_) {
+        mj_deleteSpec(base_);
+    }
+}
+
+bool VariantBuilder::load(const std::string& path) {
+    char error[1000];
+    mjSpec* spec = mj_parseXML(path.c_str(), nullptr, error, sizeof(error));
+    if (!spec) {
+        std::cerr << "[ERROR] Failed to parse model: " << path << "\n" << error << std::endl;
+        return false;
+    }
+    if (base_) {
+        mj_deleteSpec(base_);
+    }
+    base_ = spec;
+    return true;
+}
+
+int VariantBuilder::build(int count, const SpecEditFn& edit, const VariantKeyFn& key, ModelCache& cache) {
+    if (!base_) {
+        std::cerr << "[ERROR] Base spec is not loaded" << std::endl;
+        return 0;
+    }
+
+    std::atomic<int> built(0);
+    std::mutex log_mutex;
+    pool_.parallel_for(count, [&](int, int begin, int end) {
+        for (int i = begin; i < end; i++) {
+            // ベースは読み取りのみなので複数ワーカーから同時にコピーできる
+            mjSpec* spec = mj_copySpec(base_);
+            if (!spec) {
+                std::lock_guard<std::mutex> lock(log_mutex);
+                std::cerr << "[ERROR] mj_copySpec failed for variant " << i << std::endl;
+                continue;
+            }
+            mjModel* model = nullptr;
+            if (edit(spec, i)) {
+                model = mj_compile(spec, nullptr);
+            }
+            if (model) {
+                cache.insert(key(i), model);
+                built++;
+            } else {
+                std::lock_guard<std::mutex> lock(log_mutex);
+                std::cerr << "[ERROR] Failed to build variant " << i << ": " << mjs_getError(spec) << std::endl;
+            }
+            mj_deleteSpec(spec);
+        }
+    });
+    return built;
+}
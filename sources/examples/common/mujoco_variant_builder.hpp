@@ -0,0 +1,62 @@
+#pragma once
+
+#include <mujoco/mujoco.h>
+#include <functional>
+#include <string>
+#include "mujoco_model_cache.hpp"
+#include "mujoco_thread_pool.hpp"
+
+/**
+ * @file mujoco_variant_builder.hpp
+ * @brief mjSpec を使ったモデルバリアントの並列コンパイル
+ *
+ * ベースの MJCF を1回だけ `mj_parseXML` で読み込み、バリアントごとに `mj_copySpec` した複製へ
+ * `mjs_*` で編集を加えて `mj_compile` する。コピー・編集・コンパイルはワーカーで並列に行い、
+ * 結果は ModelCache に登録する。
+ */
+
+/**
+ * @brief バリアントの編集関数
+ * @param spec 編集対象（ベースの複製）
+ * @param index バリアント番号
+ * @return 成功した場合 true
+ */
+using SpecEditFn = std::function<bool(mjSpec* spec, int index)>;
+
+/**
+ * @brief バリアントのキャッシュキーを作る関数
+ */
+using VariantKeyFn = std::function<std::string(int index)>;
+
+class VariantBuilder {
+public:
+    /**
+     * @param nworker コンパイルに使うワーカー数
+     */
+    explicit VariantBuilder(int nworker);
+    ~VariantBuilder();
+
+    VariantBuilder(const VariantBuilder&) = delete;
+    VariantBuilder& operator=(const VariantBuilder&) = delete;
+
+    /**
+     * @brief ベースの MJCF を読み込む
+     * @param path MJCF ファイルのパス
+     * @return 成功した場合 true
+     */
+    bool load(const std::string& path);
+
+    /**
+     * @brief バリアントを並列にコンパイルし、キャッシュに登録する
+     * @param count バリアント数
+     * @param edit 編集関数（ワーカーから並列に呼ばれる）
+     * @param key キャッシュキーを作る関数
+     * @param cache 登録先
+     * @return コンパイルに成功したバリアント数
+     */
+    int build(int count, const SpecEditFn& edit, const VariantKeyFn& key, ModelCache& cache);
+
+private:
+    WorkerPool pool_;
+    mjSpec* base_;
+};
@@ -0,0 +1,120 @@
+#include "mujoco_vec_env.hpp"
+#include <algorithm>
+#include <iostream>
+#include <numeric>
+
+namespace {
+
+// num_envs に近く nstate と互いに素な歩幅（どの開始位置からでもバンク内の全状態を巡る）
+int reset_stride(int num_envs, int nstate) {
+    int stride = std::max(num_envs % nstate, 1);
+    while (std::gcd(stride, nstate) != 1) {
+        stride++;
+    }
+    return stride;
+}
+
+}  // namespace
+
+VecEnv::VecEnv(const mjModel* model, const VecEnvOptions& options, const VecEnvBuffers& buffers)
+    : model_(model),
+      options_(options),
+      nobs_(observation_dim(model)),
+      pool_(options.nworker),
+      episode_steps_(options.num_envs, 0),
+      reset_cursor_(options.num_envs, 0),
+      default_reset_pool_(model),
+      reset_pool_(&default_reset_pool_),
+      obs_(buffers.observations),
+      rewards_(buffers.rewards),
+      dones_(buffers.dones) {
+    if (!obs_) {
+        obs_storage_.resize(options_.num_envs * nobs_);
+        obs_ = obs_storage_.data();
+    }
+    if (!rewards_) {
+        rewards_storage_.resize(options_.num_envs);
+        rewards_ = rewards_storage_.data();
+    }
+    if (!dones_) {
+        dones_storage_.resize(options_.num_envs);
+        dones_ = dones_storage_.data();
+    }
+    if (options_.reset_keyframe >= model_->nkey) {
+        std::cerr << "[ERROR] Keyframe not found: " << options_.reset_keyframe
+                  << " (nkey=" << model_->nkey << "), using mj_resetData" << std::endl;
+        options_.reset_keyframe = -1;
+    }
+    if (options_.reset_keyframe >= 0) {
+        default_reset_pool_.add_keyframe(options_.reset_keyframe);
+    } else {
+        default_reset_pool_.add_default();
+    }
+    for (int i = 0; i < options_.num_envs; i++) {
+        data_.push_back(mj_makeData(model_));
+        reset_cursor_[i] = i;
+    }
+    reset();
+}
+
+VecEnv::~VecEnv() {
+    for (mjData* d : data_) {
+        mj_deleteData(d);
+    }
+}
+
+void VecEnv::reset_env(int env) {
+    // 環境ごとに開始位置をずらし、nstate と互いに素な歩幅で進めてバンク内の全状態を巡る
+    // （歩幅が nstate の約数だと、各環境が一部の状態しか使わなくなる）
+    int nstate = std::max(reset_pool_->size(), 1);
+    int& cursor = reset_cursor_[env];
+    cursor %= nstate;
+    reset_pool_->reset(data_[env], cursor);
+    cursor = (cursor + reset_stride(options_.num_envs, nstate)) % nstate;
+    episode_steps_[env] = 0;
+}
+
+void VecEnv::write_observation(int env) {
+    const mjData* d = data_[env];
+    double* obs = obs_ + env * nobs_;
+    mju_copy(obs, d->qpos, model_->nq);
+    mju_copy(obs + model_->nq, d->qvel, model_->nv);
+}
+
+void VecEnv::reset() {
+    pool_.parallel_for(options_.num_envs, [this](int, int begin, int end) {
+        for (int env = begin; env < end; env++) {
+            reset_env(env);
+            write_observation(env);
+            rewards_[env] = 0;
+            dones_[env] = 0;
+        }
+    });
+}
+
+void VecEnv::step(const double* actions) {
+    const int nu = model_->nu;
+    pool_.parallel_for(options_.num_envs, [this, actions, nu](int, int begin, int end) {
+        for (int env = begin; env < end; env++) {
+            mjData* d = data_[env];
+            mju_copy(d->ctrl, actions + env * nu, nu);
+            for (int i = 0; i < options_.frame_skip; i++) {
+                mj_step(model_, d);
+            }
+            episode_steps_[env]++;
+
+            rewards_[env] = reward_fn_ ? reward_fn_(model_, d) : 0;
+            bool done = done_fn_ && done_fn_(model_, d);
+            if (options_.max_episode_steps > 0 && episode_steps_[env] >= options_.max_episode_steps) {
+                done = true;
+            }
+            dones_[env] = done;
+
+            // 自動リセット
+            if (done) {
+                reset_env(env);
+            }
+            write_observation(env);
+        }
+    });
+}
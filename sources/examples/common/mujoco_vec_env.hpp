@@ -0,0 +1,129 @@
+#pragma once
+
+#include <mujoco/mujoco.h>
+#include <cstdint>
+#include <functional>
+#include <vector>
+#include "mujoco_reset_pool.hpp"
+#include "mujoco_thread_pool.hpp"
+
+/**
+ * @file mujoco_vec_env.hpp
+ * @brief 強化学習向けのベクトル化環境（gym 風 API）
+ *
+ * N 個の環境を1回の呼び出しでまとめて進める。
+ * - 行動は連続配列 [N x nu] から読み取る
+ * - 観測 [N x nobs]、報酬 [N]、終了フラグ [N] は事前確保した連続配列に書き込む（環境ごとの確保は行わない）
+ * - 観測は qpos と qvel を連結したもの (nobs = nq + nv)
+ * - エピソード終了時は自動でリセットし、観測はリセット後の値になる
+ * - リセットは ResetPool の状態を `mj_setState` で書き戻す（mjData の再確保や `mj_resetData` は行わない）
+ */
+
+/**
+ * @brief 報酬関数（物理ステップ後の状態から計算）
+ */
+using EnvRewardFn = std::function<double(const mjModel* model, const mjData* data)>;
+
+/**
+ * @brief 終了判定関数（true でエピソード終了）
+ */
+using EnvDoneFn = std::function<bool(const mjModel* model, const mjData* data)>;
+
+/**
+ * @brief ベクトル化環境の設定
+ */
+struct VecEnvOptions {
+    int num_envs = 1;             ///< 環境数
+    int frame_skip = 1;           ///< 1回の step で進める物理ステップ数
+    int max_episode_steps = 1000; ///< エピソードの最大ステップ数（0以下で無制限）
+    int reset_keyframe = -1;      ///< リセットに使うキーフレーム（-1 の場合は mj_resetData）
+    int nworker = 1;              ///< 環境を並列に進めるワーカー数
+};
+
+/**
+ * @brief 観測・報酬・終了フラグの書き込み先（共有メモリなど）。nullptr の要素は内部で確保する
+ */
+struct VecEnvBuffers {
+    double* observations = nullptr;  ///< [N x nobs]
+    double* rewards = nullptr;       ///< [N]
+    uint8_t* dones = nullptr;        ///< [N]
+};
+
+class VecEnv {
+public:
+    /**
+     * @brief ベクトル化環境を生成する
+     * @param model MuJoCoのモデルデータ（全環境で共有、VecEnv より長く生存すること）
+     * @param options 設定
+     * @param buffers 外部の書き込み先（省略時は内部で確保）
+     */
+    VecEnv(const mjModel* model, const VecEnvOptions& options, const VecEnvBuffers& buffers = VecEnvBuffers());
+    ~VecEnv();
+
+    VecEnv(const VecEnv&) = delete;
+    VecEnv& operator=(const VecEnv&) = delete;
+
+    int num_envs() const { return options_.num_envs; }
+    int action_dim() const { return model_->nu; }
+    int observation_dim() const { return nobs_; }
+
+    /**
+     * @brief model から作る環境の観測次元 (nq + nv)
+     */
+    static int observation_dim(const mjModel* model) { return model->nq + model->nv; }
+
+    void set_reward_fn(const EnvRewardFn& fn) { reward_fn_ = fn; }
+    void set_done_fn(const EnvDoneFn& fn) { done_fn_ = fn; }
+
+    /**
+     * @brief リセットに使う初期状態バンクを差し替える（乱数で生成した初期状態など）
+     * @param pool 初期状態バンク（VecEnv より長く生存すること、nullptr で既定に戻す）
+     *
+     * 各環境はエピソードごとにバンク内の状態を順番に使う。
+     */
+    void set_reset_pool(const ResetPool* pool) { reset_pool_ = pool ? pool : &default_reset_pool_; }
+
+    /**
+     * @brief 全環境をリセットし、観測を更新する
+     */
+    void reset();
+
+    /**
+     * @brief 全環境を1ステップ進める
+     * @param actions 行動 [N x nu, 行優先]
+     */
+    void step(const double* actions);
+
+    const double* observations() const { return obs_; }
+    const double* rewards() const { return rewards_; }
+    const uint8_t* dones() const { return dones_; }
+
+    /**
+     * @brief 個別環境のシミュレーションデータ（デバッグ・可視化用）
+     */
+    mjData* env_data(int env) { return data_[env]; }
+
+private:
+    void reset_env(int env);
+    void write_observation(int env);
+
+    const mjModel* model_;
+    VecEnvOptions options_;
+    int nobs_;
+
+    WorkerPool pool_;
+    std::vector<mjData*> data_;
+    std::vector<int> episode_steps_;
+    std::vector<int> reset_cursor_;  // 次のリセットで使うバンク内の状態番号
+    ResetPool default_reset_pool_;
+    const ResetPool* reset_pool_;
+    std::vector<double> obs_storage_;
+    std::vector<double> rewards_storage_;
+    std::vector<uint8_t> dones_storage_;
+    double* obs_;
+    double* rewards_;
+    uint8_t* dones_;
+
+    EnvRewardFn reward_fn_;
+    EnvDoneFn done_fn_;
+};
@@ -0,0 +1,16 @@
+#include "mujoco_warnings.hpp"
+
+void clear_reset_warnings(mjData* data) {
+    for (int warning : kResetWarnings) {
+        data->warning[warning].number = 0;
+    }
+}
+
+bool has_reset_warning(const mjData* data) {
+    for (int warning : kResetWarnings) {
+        if (data->warning[warning].number > 0) {
+            return true;
+        }
+    }
+    return false;
+}
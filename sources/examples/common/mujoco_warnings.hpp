@@ -0,0 +1,29 @@
+#pragma once
+
+#include <mujoco/mujoco.h>
+
+/**
+ * @file mujoco_warnings.hpp
+ * @brief MuJoCo が状態を初期化してしまう警告の検出
+ *
+ * BADQPOS / BADQVEL / BADQACC / BADCTRL が出ると、mj_step は mj_resetData で状態を初期化する。
+ * mj_resetData は警告の回数も 0 にしてから 1 を数えるため、回数の増減では2回目以降を見逃す。
+ * そこで判定の前に clear_reset_warnings() で 0 に戻し、has_reset_warning() で 1 以上になったかを見る。
+ */
+
+/// mj_step が状態を初期化してしまう警告
+constexpr int kResetWarnings[] = {mjWARN_BADQPOS, mjWARN_BADQVEL, mjWARN_BADQACC, mjWARN_BADCTRL};
+constexpr int kNumResetWarnings = sizeof(kResetWarnings) / sizeof(kResetWarnings[0]);
+
+/**
+ * @brief kResetWarnings の回数を 0 に戻す
+ * @param data 対象のデータ
+ */
+void clear_reset_warnings(mjData* data);
+
+/**
+ * @brief 前回の clear_reset_warnings() 以降に kResetWarnings のいずれかが出たか
+ * @param data 対象のデータ
+ * @return 出ていれば true（状態は初期化されている）
+ */
+bool has_reset_warning(const mjData* data);
@@ -0,0 +1,120 @@
+#include "mujoco_watchdog.hpp"
+#include "mujoco_warnings.hpp"
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+
+namespace {
+
+// 指数部が全て1（Inf / NaN）の要素があれば false
+// 分岐の無い整数演算だけなので、コンパイラがベクトル化できる
+bool all_finite(const mjtNum* values, int n) {
+    const uint64_t exponent = 0x7ff0000000000000ULL;
+    uint64_t bad = 0;
+    for (int i = 0; i < n; i++) {
+        uint64_t bits;
+        std::memcpy(&bits, &values[i], sizeof(bits));
+        bad |= static_cast<uint64_t>((bits & exponent) == exponent);
+    }
+    return bad == 0;
+}
+
+}  // namespace
+
+StepWatchdog::StepWatchdog(mjModel* model, mjData* data, const WatchdogOptions& options)
+    : model_(model),
+      options_(options),
+      base_timestep_(model->opt.timestep),
+      state_size_(mj_stateSize(model, mjSTATE_INTEGRATION)),
+      ring_(static_cast<size_t>(options.ring_size > 0 ? options.ring_size : 1) * state_size_),
+      ring_head_(0),
+      ring_count_(0),
+      step_(0),
+      level_(0),
+      recovery_left_(0),
+      rollbacks_(0) {
+    if (options_.ring_size < 1) {
+        options_.ring_size = 1;
+    }
+    if (options_.snapshot_interval < 1) {
+        options_.snapshot_interval = 1;
+    }
+    clear_reset_warnings(data);
+}
+
+bool StepWatchdog::healthy(const mjData* data) const {
+    if (has_reset_warning(data)) {
+        return false;
+    }
+    return all_finite(data->qpos, model_->nq) && all_finite(data->qvel, model_->nv) &&
+           all_finite(data->qacc, model_->nv) && all_finite(data->act, model_->na);
+}
+
+void StepWatchdog::save(const mjData* data) {
+    mj_getState(model_, data, ring_.data() + static_cast<size_t>(ring_head_) * state_size_, mjSTATE_INTEGRATION);
+    ring_head_ = (ring_head_ + 1) % options_.ring_size;
+    if (ring_count_ < options_.ring_size) {
+        ring_count_++;
+    }
+}
+
+void StepWatchdog::clear(mjData* data) {
+    ring_head_ = 0;
+    ring_count_ = 0;
+    step_ = 0;
+    level_ = 0;
+    recovery_left_ = 0;
+    model_->opt.timestep = base_timestep_;
+    clear_reset_warnings(data);
+}
+
+bool StepWatchdog::rollback(mjData* data) {
+    if (ring_count_ == 0) {
+        return false;
+    }
+    // 連続して失敗するほど古い状態へ戻り、timestep も縮める
+    if (level_ < options_.max_level) {
+        level_++;
+    }
+    int back = level_ < ring_count_ ? level_ : ring_count_;
+    int index = (ring_head_ - back + options_.ring_size) % options_.ring_size;
+    mj_setState(model_, data, ring_.data() + static_cast<size_t>(index) * state_size_, mjSTATE_INTEGRATION);
+
+    // 戻した状態より新しい保存は発散前の軌道なので捨てる
+    ring_head_ = (index + 1) % options_.ring_size;
+    ring_count_ -= back - 1;
+
+    model_->opt.timestep = base_timestep_ * std::pow(options_.timestep_scale, level_);
+    recovery_left_ = options_.recovery_steps;
+    mj_forward(model_, data);
+    clear_reset_warnings(data);
+    rollbacks_++;
+    return true;
+}
+
+WatchdogStatus StepWatchdog::after_step(mjData* data) {
+    if (!healthy(data)) {
+        double t = data->time;
+        if (!rollback(data)) {
+            std::cerr << "[ERROR] Watchdog: instability at t=" << t << " with no saved state" << std::endl;
+            clear_reset_warnings(data);
+            return WatchdogStatus::Failed;
+        }
+        std::cerr << "[ERROR] Watchdog: instability at t=" << t << ", rolled back to t=" << data->time
+                  << " with timestep " << model_->opt.timestep << std::endl;
+        return WatchdogStatus::RolledBack;
+    }
+
+    // 回復期間が終わったら timestep を元に戻す
+    if (level_ > 0 && --recovery_left_ <= 0) {
+        level_ = 0;
+        model_->opt.timestep = base_timestep_;
+        std::cout << "[INFO] Watchdog: recovered at t=" << data->time << std::endl;
+    }
+
+    if (step_++ % options_.snapshot_interval == 0) {
+        save(data);
+    }
+    return WatchdogStatus::Healthy;
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <mujoco/mujoco.h>
+#include <vector>
+
+/**
+ * @file mujoco_watchdog.hpp
+ * @brief 発散を検出して直前の状態へ巻き戻すウォッチドッグ
+ *
+ * 毎ステップ後に次を確認する。
+ * - `mjData::warning` の BADQPOS / BADQVEL / BADQACC / BADCTRL が出ていないか
+ *   （判定方法は mujoco_warnings.hpp を参照）
+ * - qpos / qvel / qacc / act が全て有限か（ビット演算のみのループで、コンパイラがベクトル化できる）
+ *
+ * 健全な状態は一定ステップごとに `mjSTATE_INTEGRATION` で固定長のリングバッファに保存しておき、
+ * 異常を検出したらリング内の状態へ巻き戻し、timestep を縮めた状態で一定ステップ進めてから元に戻す。
+ * 巻き戻し直後に再び異常になった場合は、さらに古い状態へ戻り timestep も更に縮める。
+ *
+ * @note 巻き戻しで状態が不連続になるため、InputRecorder で記録する場合は RolledBack の後に
+ *       InputRecorder::record_rewind() で巻き戻した状態を記録する
+ */
+
+/**
+ * @brief ウォッチドッグの設定
+ */
+struct WatchdogOptions {
+    int ring_size = 32;             ///< 保存しておく状態の数
+    int snapshot_interval = 10;     ///< 状態を保存するステップ間隔
+    int recovery_steps = 500;       ///< timestep を縮めて進めるステップ数
+    double timestep_scale = 0.5;    ///< 巻き戻し1回あたりの timestep の倍率
+    int max_level = 4;              ///< timestep を縮める最大回数（連続した巻き戻し）
+};
+
+/**
+ * @brief 1ステップ後の判定結果
+ */
+enum class WatchdogStatus {
+    Healthy,     ///< 異常なし
+    RolledBack,  ///< 異常を検出して巻き戻した
+    Failed,      ///< 巻き戻せる状態が無かった（状態はそのまま）
+};
+
+class StepWatchdog {
+public:
+    /**
+     * @param model MuJoCoのモデルデータ（回復中は opt.timestep を書き換える）
+     * @param data 監視するシミュレーションデータ（監視する警告の回数を 0 にする）
+     * @param options 設定
+     */
+    StepWatchdog(mjModel* model, mjData* data, const WatchdogOptions& options = WatchdogOptions());
+
+    /**
+     * @brief mj_step の直後に呼び、異常があれば巻き戻す
+     * @param data シミュレーションデータ
+     * @return 判定結果
+     */
+    WatchdogStatus after_step(mjData* data);
+
+    /**
+     * @brief 保存した状態を捨てる（リセットや外部からの状態変更の後に呼ぶ）
+     */
+    void clear(mjData* data);
+
+    /**
+     * @brief これまでの巻き戻し回数
+     */
+    int rollbacks() const { return rollbacks_; }
+
+    /**
+     * @brief 回復中（timestep を縮めている）か
+     */
+    bool recovering() const { return level_ > 0; }
+
+private:
+    bool healthy(const mjData* data) const;
+    void save(const mjData* data);
+    bool rollback(mjData* data);
+
+    mjModel* model_;
+    WatchdogOptions options_;
+    double base_timestep_;
+    int state_size_;
+
+    std::vector<mjtNum> ring_;  // [ring_size x state_size]
+    int ring_head_;             // 次に書く位置
+    int ring_count_;            // 保存済みの数
+    int step_;
+
+    int level_;                 // 現在の timestep 縮小回数
+    int recovery_left_;         // 元の timestep に戻すまでの残りステップ
+    int rollbacks_;
+};
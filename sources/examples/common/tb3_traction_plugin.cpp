@@ -0,0 +1,178 @@
+#include "tb3_traction_plugin.hpp"
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+
+namespace {
+
+const char* const kAttributes[] = {"radius", "stiffness", "damping", "mu", "lateral_mu", "slip_velocity"};
+
+// インスタンスごとのデータ（mjData::plugin_data に保持する）
+struct Tb3Traction {
+    int body = -1;
+    double ground_z = 0;
+    Tb3TractionParams params = {};
+};
+
+int plugin_slot = -1;
+
+double read_scalar(const mjModel* m, int instance, const char* key, double fallback) {
+    const char* text = mj_getPluginConfig(m, instance, key);
+    if (!text || !text[0]) {
+        return fallback;
+    }
+    char* end = nullptr;
+    double value = std::strtod(text, &end);
+    return end == text ? fallback : value;
+}
+
+int traction_nstate(const mjModel*, int) {
+    return 0;
+}
+
+int traction_init(const mjModel* m, mjData* d, int instance) {
+    Tb3Traction* traction = new Tb3Traction();
+    for (int b = 0; b < m->nbody; b++) {
+        if (m->body_plugin[b] == instance) {
+            traction->body = b;
+            break;
+        }
+    }
+    if (traction->body < 0) {
+        std::cerr << "[ERROR] " << kTb3TractionPluginName << ": instance " << instance
+                  << " is not attached to a body" << std::endl;
+        delete traction;
+        return -1;
+    }
+
+    // 既定の半径は車輪ボディの最初の円柱、地面はワールドの最初の plane
+    double radius = 0;
+    for (int g = 0; g < m->ngeom; g++) {
+        if (m->geom_bodyid[g] == traction->body && m->geom_type[g] == mjGEOM_CYLINDER) {
+            radius = m->geom_size[3 * g];
+            break;
+        }
+    }
+    for (int g = 0; g < m->ngeom; g++) {
+        if (m->geom_bodyid[g] == 0 && m->geom_type[g] == mjGEOM_PLANE) {
+            traction->ground_z = m->geom_pos[3 * g + 2];
+            break;
+        }
+    }
+
+    Tb3TractionParams& p = traction->params;
+    p.radius = read_scalar(m, instance, "radius", radius);
+    p.stiffness = read_scalar(m, instance, "stiffness", 1000.0);
+    p.damping = read_scalar(m, instance, "damping", 20.0);
+    p.mu = read_scalar(m, instance, "mu", 1.1);
+    p.lateral_mu = read_scalar(m, instance, "lateral_mu", p.mu);
+    p.slip_velocity = read_scalar(m, instance, "slip_velocity", 0.1);
+    if (p.radius <= 0 || p.slip_velocity <= 0) {
+        std::cerr << "[ERROR] " << kTb3TractionPluginName << ": radius and slip_velocity must be positive"
+                  << std::endl;
+        delete traction;
+        return -1;
+    }
+    d->plugin_data[instance] = reinterpret_cast<uintptr_t>(traction);
+    return 0;
+}
+
+void traction_destroy(mjData* d, int instance) {
+    delete reinterpret_cast<Tb3Traction*>(d->plugin_data[instance]);
+    d->plugin_data[instance] = 0;
+}
+
+void traction_copy(mjData* dest, const mjModel*, const mjData* src, int instance) {
+    const Tb3Traction* traction = reinterpret_cast<const Tb3Traction*>(src->plugin_data[instance]);
+    dest->plugin_data[instance] = reinterpret_cast<uintptr_t>(new Tb3Traction(*traction));
+}
+
+void traction_reset(const mjModel*, mjtNum*, void*, int) {
+}
+
+void traction_compute(const mjModel* m, mjData* d, int instance, int) {
+    const Tb3Traction* traction = reinterpret_cast<const Tb3Traction*>(d->plugin_data[instance]);
+    const Tb3TractionParams& p = traction->params;
+    const int b = traction->body;
+    const mjtNum* center = d->xpos + 3 * b;
+
+    double penetration = p.radius - (center[2] - traction->ground_z);
+    if (penetration <= 0) {
+        return;
+    }
+
+    // 車輪中心の速度（ワールド座標系）と接地点の速度 v_c = v + ω x (c - p)
+    mjtNum vel[6];
+    mj_objectVelocity(m, d, mjOBJ_XBODY, b, vel, 0);
+    const mjtNum* w = vel;
+    const mjtNum arm[3] = {0, 0, -(center[2] - traction->ground_z)};
+    mjtNum spin[3];
+    mju_cross(spin, w, arm);
+    mjtNum vc[3] = {vel[3] + spin[0], vel[4] + spin[1], vel[5] + spin[2]};
+
+    // 前後方向は車軸（車輪ボディの z 軸）と地面の法線に垂直な方向
+    const mjtNum* xmat = d->xmat + 9 * b;
+    mjtNum axle[3] = {xmat[2], xmat[5], xmat[8]};
+    const mjtNum up[3] = {0, 0, 1};
+    mjtNum forward[3], lateral[3];
+    mju_cross(forward, axle, up);
+    if (mju_normalize3(forward) < mjMINVAL) {
+        return;  // 車輪が倒れて車軸が鉛直
+    }
+    mju_cross(lateral, up, forward);
+
+    double normal = p.stiffness * penetration - p.damping * vc[2];
+    if (normal <= 0) {
+        return;
+    }
+    double fx = -p.mu * normal * std::tanh(mju_dot3(vc, forward) / p.slip_velocity);
+    double fy = -p.lateral_mu * normal * std::tanh(mju_dot3(vc, lateral) / p.slip_velocity);
+    double limit = std::fmax(p.mu, p.lateral_mu) * normal;
+    double magnitude = std::sqrt(fx * fx + fy * fy);
+    if (magnitude > limit) {
+        fx *= limit / magnitude;
+        fy *= limit / magnitude;
+    }
+
+    mjtNum force[3];
+    for (int i = 0; i < 3; i++) {
+        force[i] = normal * up[i] + fx * forward[i] + fy * lateral[i];
+    }
+    const mjtNum torque[3] = {0, 0, 0};
+    const mjtNum contact[3] = {center[0], center[1], traction->ground_z};
+    mj_applyFT(m, d, force, torque, contact, b, d->qfrc_passive);
+}
+
+}  // namespace
+
+bool register_tb3_traction_plugin() {
+    if (plugin_slot >= 0) {
+        return true;
+    }
+    mjpPlugin plugin;
+    mjp_defaultPlugin(&plugin);
+    plugin.name = kTb3TractionPluginName;
+    plugin.capabilityflags = mjPLUGIN_PASSIVE;
+    plugin.nattribute = sizeof(kAttributes) / sizeof(kAttributes[0]);
+    plugin.attributes = kAttributes;
+    plugin.nstate = traction_nstate;
+    plugin.init = traction_init;
+    plugin.destroy = traction_destroy;
+    plugin.copy = traction_copy;
+    plugin.reset = traction_reset;
+    plugin.compute = traction_compute;
+    plugin_slot = mjp_registerPlugin(&plugin);
+    if (plugin_slot < 0) {
+        std::cerr << "[ERROR] Failed to register plugin: " << kTb3TractionPluginName << std::endl;
+        return false;
+    }
+    return true;
+}
+
+Tb3TractionParams* tb3_traction_params(const mjModel* model, mjData* data, int instance) {
+    if (plugin_slot < 0 || instance < 0 || instance >= model->nplugin || model->plugin[instance] != plugin_slot) {
+        return nullptr;
+    }
+    return &reinterpret_cast<Tb3Traction*>(data->plugin_data[instance])->params;
+}
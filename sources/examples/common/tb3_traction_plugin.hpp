@@ -0,0 +1,58 @@
+#pragma once
+
+#include <mujoco/mujoco.h>
+
+/**
+ * @file tb3_traction_plugin.hpp
+ * @brief 車輪と地面の接触を解析的なタイヤモデルで置き換える受動力プラグイン
+ *
+ * 車輪ジオムの接触を contype="0" conaffinity="0" で無効にし、代わりに車輪ボディごとに次の力を与える。
+ * 制約ソルバを通らないため、接触解決のコストを車輪の分だけ削減できる。
+ * - 垂直: 地面（ワールドの plane ジオム、法線は +z）へのめり込み δ に対するばね・ダンパ
+ *         Fn = max(0, stiffness * δ - damping * vz)
+ * - 接地点の滑り速度 v（前後・横）に対する飽和型の摩擦
+ *         F = -mu * Fn * tanh(v / slip_velocity)  （前後と横の合力は mu * Fn で打ち切る）
+ *
+ * 低速のロボットでは滑り率が 0 除算になりやすいため、滑り率ではなく滑り速度で飽和させる。
+ * 力は陽に与えられる（陰的積分器の微分に含まれない）ため、timestep に対して
+ * stiffness / damping / slip_velocity が硬すぎると振動する。既定値は timestep 0.02 の tb3 向け。
+ *
+ * MJCF での使い方（mj_loadXML の前に register_tb3_traction_plugin() を呼ぶ）:
+ * @code{.xml}
+ * <extension>
+ *   <plugin plugin="hakoniwa.tb3_traction">
+ *     <instance name="left_traction"> <config key="mu" value="1.1"/> </instance>
+ *   </plugin>
+ * </extension>
+ * <body name="left_wheel"> <plugin instance="left_traction"/> ... </body>
+ * @endcode
+ *
+ * 設定項目（省略時の値）: radius（車輪ボディの最初の円柱ジオムの半径）, stiffness (1000 N/m),
+ * damping (20 Ns/m), mu (1.1), lateral_mu (mu), slip_velocity (0.1 m/s)
+ */
+
+constexpr const char* kTb3TractionPluginName = "hakoniwa.tb3_traction";
+
+/**
+ * @brief タイヤモデルの係数
+ */
+struct Tb3TractionParams {
+    double radius;          ///< 車輪半径 [m]
+    double stiffness;       ///< 垂直ばね [N/m]
+    double damping;         ///< 垂直ダンパ [Ns/m]
+    double mu;              ///< 前後方向の摩擦係数
+    double lateral_mu;      ///< 横方向の摩擦係数
+    double slip_velocity;   ///< 摩擦が飽和する滑り速度の目安 [m/s]
+};
+
+/**
+ * @brief プラグインを MuJoCo に登録する（複数回呼んでもよい）
+ * @return 登録済みまたは登録に成功した場合 true
+ */
+bool register_tb3_traction_plugin();
+
+/**
+ * @brief mjData ごとの係数を取得する（実行中に書き換えると次のステップから反映される）
+ * @return このプラグインのインスタンスでない場合 nullptr
+ */
+Tb3TractionParams* tb3_traction_params(const mjModel* model, mjData* data, int instance);
@@ -0,0 +1,149 @@
+#include <mujoco/mujoco.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "drone_hover_lqr.hpp"
+#include "mujoco_adaptive_step.hpp"
+
+// drone をホバリングLQRで離れた目標へ移動させ、途中で短い外乱（衝撃）を与える場面で、
+// 固定 timestep と可変 timestep（AdaptiveStepper）のステップ数・時間・精度を比べる。
+// 精度は timestep を 1/20 にした固定 timestep の軌道を基準に、一定間隔の機体位置のずれで測る。
+// 使い方: adaptive_bench [duration_s] [model_path]
+
+static const double sample_interval = 0.05;   // 位置を比べる間隔 [s]
+static const double impulse_time = 2.0;       // 外乱を与える時刻 [s]
+static const double impulse_duration = 0.05;
+static const double impulse_force[3] = {4.0, 0.0, -2.0};
+
+struct RunResult {
+    long long steps = 0;
+    long long mj_steps = 0;
+    double wall_ms = 0;
+    std::vector<mjtNum> samples;   // sample_interval ごとの機体位置
+};
+
+// fixed_timestep > 0 で固定、0 で stepper を使う
+static RunResult run(mjModel* model, const DroneHoverLqr& controller, int body, double duration,
+                     double fixed_timestep, AdaptiveStepper* stepper) {
+    const double base_timestep = model->opt.timestep;
+    RunResult result;
+    mjData* data = mj_makeData(model);
+    const ConstJointView base = DroneHoverLqr::bind_base(model, data);
+    mj_forward(model, data);
+    result.samples.insert(result.samples.end(), data->xpos + 3 * body, data->xpos + 3 * body + 3);
+
+    double next_sample = sample_interval;
+    auto start = std::chrono::steady_clock::now();
+    while (data->time < duration - 1e-9) {
+        controller.compute(base, data->ctrl);
+        bool impulse = data->time >= impulse_time && data->time < impulse_time + impulse_duration;
+        for (int i = 0; i < 3; i++) {
+            data->xfrc_applied[6 * body + i] = impulse ? impulse_force[i] : 0.0;
+        }
+
+        // サンプル時刻と外乱の境界をまたがないように timestep を打ち切る
+        double limit = next_sample - data->time;
+        if (data->time < impulse_time) {
+            limit = std::min(limit, impulse_time - data->time);
+        } else if (data->time < impulse_time + impulse_duration) {
+            limit = std::min(limit, impulse_time + impulse_duration - data->time);
+        }
+        if (fixed_timestep > 0) {
+            model->opt.timestep = std::min(fixed_timestep, limit);
+            mj_step(model, data);
+            result.mj_steps++;
+        } else {
+            double proposed = model->opt.timestep;
+            double shortened = std::min(proposed, limit);
+            long long rejected = stepper->rejected();
+            model->opt.timestep = shortened;
+            double taken = stepper->step(model, data);
+            // 打ち切った h がやり直しなしで採用された場合だけ、打ち切りで縮めた分を次のステップに持ち越さない
+            // （誤差でやり直した場合は stepper が選んだ h を使う）
+            if (shortened < proposed && taken == std::max(shortened, stepper->options().min_timestep) &&
+                stepper->rejected() == rejected) {
+                model->opt.timestep = std::max(model->opt.timestep, proposed);
+            }
+        }
+        result.steps++;
+
+        if (data->time >= next_sample - 1e-9) {
+            result.samples.insert(result.samples.end(), data->xpos + 3 * body, data->xpos + 3 * body + 3);
+            next_sample += sample_interval;
+        }
+    }
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+    result.wall_ms = elapsed.count();
+    if (stepper) {
+        result.mj_steps = stepper->mj_steps();
+    }
+    mj_deleteData(data);
+    model->opt.timestep = base_timestep;
+    return result;
+}
+
+static double max_deviation(const RunResult& result, const RunResult& reference) {
+    double error = 0;
+    size_t n = std::min(result.samples.size(), reference.samples.size());
+    for (size_t i = 0; i + 2 < n; i += 3) {
+        error = std::max(error, mju_dist3(result.samples.data() + i, reference.samples.data() + i));
+    }
+    return error;
+}
+
+static void print_row(const std::string& name, const RunResult& result, const RunResult& reference) {
+    std::cout << std::setw(22) << name << std::setw(10) << result.steps << std::setw(10) << result.mj_steps
+              << std::setw(12) << std::fixed << std::setprecision(2) << result.wall_ms << std::setw(14)
+              << std::scientific << std::setprecision(2) << max_deviation(result, reference) << std::endl;
+}
+
+int main(int argc, const char* argv[]) {
+    double duration = argc > 1 ? std::stod(argv[1]) : 5.0;
+    std::string model_path = argc > 2 ? argv[2] : "models/drone.xml";
+
+    char error[1000];
+    mjModel* model = mj_loadXML(model_path.c_str(), nullptr, error, sizeof(error));
+    if (!model) {
+        std::cerr << "[ERROR] Failed to load model: " << model_path << "\n" << error << std::endl;
+        return 1;
+    }
+    int body = mj_name2id(model, mjOBJ_BODY, "drone_base");
+    DroneHoverLqr controller;
+    if (body < 0 || !controller.build(model, std::thread::hardware_concurrency())) {
+        std::cerr << "[ERROR] Failed to set up the hover controller" << std::endl;
+        mj_deleteModel(model);
+        return 1;
+    }
+    const double target[3] = {0.5, -0.3, 1.0};
+    controller.set_target(target, 0.5);
+
+    const double base = model->opt.timestep;
+    std::cout << "[INFO] duration=" << duration << " s, base timestep=" << base << " s" << std::endl;
+    RunResult reference = run(model, controller, body, duration, base / 20, nullptr);
+
+    std::cout << std::setw(22) << "mode" << std::setw(10) << "steps" << std::setw(10) << "mj_step" << std::setw(12)
+              << "wall[ms]" << std::setw(14) << "max_err[m]" << std::endl;
+    print_row("fixed " + std::to_string(base), run(model, controller, body, duration, base, nullptr), reference);
+    print_row("fixed " + std::to_string(base / 4), run(model, controller, body, duration, base / 4, nullptr),
+              reference);
+    for (double tolerance : {1e-4, 1e-5, 1e-6}) {
+        AdaptiveStepOptions options;
+        options.max_timestep = sample_interval;
+        options.position_tolerance = tolerance;
+        options.velocity_tolerance = 10 * tolerance;
+        AdaptiveStepper stepper(options);
+        RunResult result = run(model, controller, body, duration, 0, &stepper);
+        std::ostringstream name;
+        name << "adaptive tol=" << std::scientific << std::setprecision(0) << tolerance;
+        print_row(name.str(), result, reference);
+        std::cout << std::setw(22) << "" << "  rejected=" << stepper.rejected() << std::endl;
+    }
+    mj_deleteModel(model);
+    return 0;
+}
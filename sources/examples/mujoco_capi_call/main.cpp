@@ -6,26 +6,56 @@
 #include <mutex>
 #include "mujoco_debug.hpp"
 #include "mujoco_viewer.hpp"
+#include "mujoco_model_reloader.hpp"
+#include "mujoco_async_logger.hpp"
+#include "mujoco_adaptive_step.hpp"
+#include "mujoco_state_view.hpp"
 
 // MuJoCoのモデルとデータ
 static mjData* mujoco_data;
 static mjModel* mujoco_model;
 static const std::string model_path = "models/tb3.xml";
 
+// 左右モーターのビュー（ホットリロードでアドレスが変わるため、リロード時に引き直す）
+struct Tb3Motors {
+    ActuatorView left;
+    ActuatorView right;
+
+    bool bind(const mjModel* model, mjData* data) {
+        left = ActuatorView::bind(model, data, "left_motor");
+        right = ActuatorView::bind(model, data, "right_motor");
+        return left.valid() && right.valid();
+    }
+};
+
 // シミュレーションスレッド
-void simulation_thread(mjModel* model, mjData* data, bool& running_flag, std::mutex& mutex) {
+void simulation_thread(mjModel* model, mjData* data, bool& running_flag, std::mutex& mutex, AsyncLogger& logger,
+                       const Tb3Motors& motors, bool adaptive) {
     double simulation_timestep = model->opt.timestep;  // **XMLから `timestep` を取得**
-    std::cout << "[INFO] Simulation timestep: " << simulation_timestep << " sec" << std::endl;
+    std::cout << "[INFO] Simulation timestep: " << simulation_timestep << " sec"
+              << (adaptive ? " (adaptive)" : "") << std::endl;
+
+    // 局所誤差に応じて timestep を伸び縮みさせる（--adaptive の場合）
+    AdaptiveStepOptions adaptive_options;
+    adaptive_options.max_timestep = 5 * model->opt.timestep;
+    AdaptiveStepper stepper(adaptive_options);
 
     while (running_flag) {
         auto start = std::chrono::steady_clock::now();
 
         {
             std::lock_guard<std::mutex> lock(mutex);
-            data->ctrl[0] = 0.2;  // 左モーター
-            data->ctrl[1] = 0.5;  // 右モーター
-            mj_step(model, data);
-            //print_body_state_by_name(model, data, "tb3_base");
+            if (motors.left.valid() && motors.right.valid()) {  // リロード後のモデルに無い場合は入力しない
+                motors.left.ctrl() = 0.2;
+                motors.right.ctrl() = 0.5;
+            }
+            if (adaptive) {
+                simulation_timestep = stepper.step(model, data);  // 実際に進めた時間でペーシングする
+            } else {
+                simulation_timestep = model->opt.timestep;  // ホットリロードで変わる場合がある
+                mj_step(model, data);
+            }
+            logger.log(data);  // 整形・出力は別スレッドで行う
         }
 
         auto end = std::chrono::steady_clock::now();
@@ -39,8 +69,10 @@ void simulation_thread(mjModel* model, mjData* data, bool& running_flag, std::mu
 }
 
 
+// 使い方: main [--adaptive]
 int main(int argc, const char* argv[])
 {
+    const bool adaptive = argc > 1 && std::string(argv[1]) == "--adaptive";
     // **MuJoCoモデルの読み込み**
     char error[1000];
     std::cout << "[INFO] Loading model: " << model_path << std::endl;
@@ -57,6 +89,13 @@ int main(int argc, const char* argv[])
 
     // **初期状態を正しく計算する**
     mj_forward(mujoco_model, mujoco_data);
+
+    Tb3Motors motors;
+    if (!motors.bind(mujoco_model, mujoco_data)) {
+        mj_deleteData(mujoco_data);
+        mj_deleteModel(mujoco_model);
+        return 1;
+    }
     
     // **シミュレーションの実行**
     const double dt = mujoco_model->opt.timestep;
@@ -64,10 +103,32 @@ int main(int argc, const char* argv[])
     
     std::mutex data_mutex;
     bool running_flag = true;
-    std::thread sim_thread(simulation_thread, mujoco_model, mujoco_data, std::ref(running_flag), std::ref(data_mutex));
+
+    // **状態ログ（JSON Lines、シミュレーション時刻で 50Hz に間引く）**
+    AsyncLogger logger(mujoco_model, std::make_unique<JsonLinesSink>("tb3_state.jsonl"), 50.0);
+    logger.add_joint("left_wheel_hinge");
+    logger.add_joint("right_wheel_hinge");
+    logger.add_body("tb3_base");
+    logger.add_actuator("left_motor");
+    logger.add_actuator("right_motor");
+    logger.start();
+
+    std::thread sim_thread(simulation_thread, mujoco_model, mujoco_data, std::ref(running_flag), std::ref(data_mutex),
+                           std::ref(logger), std::cref(motors), adaptive);
+
+    // **モデルファイルの監視（編集すると状態を保ったまま再コンパイル）**
+    ModelReloader reloader(model_path, mujoco_model, mujoco_data, data_mutex);
+    reloader.set_reload_hook([&logger, &motors](const mjModel* model) {  // ID を名前で引き直す
+        logger.rebind(model);
+        motors.bind(model, mujoco_data);
+    });
+    std::thread watcher_thread(model_watcher_thread, std::ref(reloader), std::ref(running_flag), 500);
+
     viewer_thread(mujoco_model, mujoco_data, std::ref(running_flag), std::ref(data_mutex));
     running_flag = false;
     sim_thread.join();
+    watcher_thread.join();
+    logger.stop();
     // **リソース解放**
     std::cout << "[INFO] Cleaning up resources." << std::endl;
     mj_deleteData(mujoco_data);
@@ -0,0 +1,133 @@
+#include <mujoco/mujoco.h>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "mujoco_collision_filter.hpp"
+
+// ロボット内で接触し得ないジオム対を解析して <exclude> を生成し、
+// 1台と複数台のシーンで衝突検出（broadphase / narrowphase）の時間を比較する
+// 使い方: collision_filter [model_path] [robots] [out_path]
+//   out_path を指定すると、exclude を追加した1台のモデルを mjSpec 経由で保存する
+
+// 1台目はそのまま、2台目以降は最初のルートボディを横に並べて取り付ける
+static mjSpec* build_scene(const std::string& path, int robots, mjSpec** child_out) {
+    char error[1000];
+    mjSpec* scene = mj_parseXML(path.c_str(), nullptr, error, sizeof(error));
+    if (!scene) {
+        std::cerr << "[ERROR] Failed to parse model: " << path << "\n" << error << std::endl;
+        return nullptr;
+    }
+    *child_out = nullptr;
+    if (robots <= 1) {
+        return scene;
+    }
+    mjSpec* child = mj_parseXML(path.c_str(), nullptr, error, sizeof(error));
+    mjsBody* robot = child ? mjs_asBody(mjs_firstChild(mjs_findBody(child, "world"), mjOBJ_BODY, 0)) : nullptr;
+    if (!robot) {
+        std::cerr << "[ERROR] No robot body in " << path << std::endl;
+        if (child) {
+            mj_deleteSpec(child);
+        }
+        mj_deleteSpec(scene);
+        return nullptr;
+    }
+    mjsBody* world = mjs_findBody(scene, "world");
+    for (int k = 1; k < robots; k++) {
+        mjsFrame* frame = mjs_addFrame(world, nullptr);
+        frame->pos[0] = 0.5 * (k % 4);
+        frame->pos[1] = 0.5 * (k / 4);
+        std::string prefix = "robot" + std::to_string(k) + "_";
+        if (!mjs_attachBody(frame, robot, prefix.c_str(), "")) {
+            std::cerr << "[ERROR] mjs_attachBody failed: " << mjs_getError(scene) << std::endl;
+        }
+    }
+    // 取り付けた要素はコンパイルまで元の mjSpec を参照するため、呼び出し側で後から削除する
+    *child_out = child;
+    return scene;
+}
+
+static void print_timing(const std::string& label, const CollisionTiming& t) {
+    std::cout << "[INFO] " << std::left << std::setw(22) << label << std::right << std::fixed << std::setprecision(2)
+              << " broad " << std::setw(7) << t.broad_us << " us | narrow " << std::setw(7) << t.narrow_us
+              << " us | step " << std::setw(7) << t.step_us << " us | contacts " << std::setw(5) << t.ncon
+              << std::defaultfloat << std::setprecision(6) << std::endl;
+}
+
+// シーンを解析して exclude を追加する前後の時間を比べる
+static bool compare_scene(const std::string& path, int robots, int steps, const std::string& out_path) {
+    mjSpec* child = nullptr;
+    mjSpec* spec = build_scene(path, robots, &child);
+    if (!spec) {
+        return false;
+    }
+    mjModel* before = mj_compile(spec, nullptr);
+    if (!before) {
+        std::cerr << "[ERROR] Failed to compile scene: " << mjs_getError(spec) << std::endl;
+        mj_deleteSpec(spec);
+        if (child) {
+            mj_deleteSpec(child);
+        }
+        return false;
+    }
+
+    CollisionFilterOptions options;
+    std::vector<GeomPairStat> pairs = analyze_geom_pairs(before, options);
+    std::vector<BodyExclude> excludes = propose_excludes(before, pairs, options.touch_distance);
+    std::cout << "\n[INFO] " << robots << " robot(s): " << before->ngeom << " geoms, " << pairs.size()
+              << " intra-robot candidate pairs, " << excludes.size() << " body excludes" << std::endl;
+    if (robots == 1) {
+        for (const GeomPairStat& pair : pairs) {
+            std::cout << "[Pair] " << mj_id2name(before, mjOBJ_GEOM, pair.geom1) << " - "
+                      << mj_id2name(before, mjOBJ_GEOM, pair.geom2) << " | min distance " << pair.min_distance
+                      << " m" << std::endl;
+        }
+        for (const BodyExclude& exclude : excludes) {
+            std::cout << "<exclude body1=\"" << exclude.body1 << "\" body2=\"" << exclude.body2 << "\"/>" << std::endl;
+        }
+    }
+
+    apply_excludes(spec, excludes);
+    mjModel* after = mj_compile(spec, nullptr);
+    bool ok = after != nullptr;
+    if (!ok) {
+        std::cerr << "[ERROR] Failed to compile filtered scene: " << mjs_getError(spec) << std::endl;
+    } else {
+        CollisionTiming t0 = measure_collision_time(before, steps);
+        CollisionTiming t1 = measure_collision_time(after, steps);
+        print_timing("default filter", t0);
+        print_timing("with excludes", t1);
+        std::cout << "[INFO] Narrowphase saved: " << t0.narrow_us - t1.narrow_us << " us/step ("
+                  << (t0.narrow_us > 0 ? 100.0 * (t0.narrow_us - t1.narrow_us) / t0.narrow_us : 0.0) << " %)"
+                  << std::endl;
+        if (!out_path.empty()) {
+            char error[1000];
+            if (mj_saveXML(spec, out_path.c_str(), error, sizeof(error)) != 0) {
+                std::cerr << "[ERROR] Failed to save model: " << out_path << "\n" << error << std::endl;
+                ok = false;
+            } else {
+                std::cout << "[INFO] Wrote " << out_path << std::endl;
+            }
+        }
+        mj_deleteModel(after);
+    }
+    mj_deleteModel(before);
+    mj_deleteSpec(spec);
+    if (child) {
+        mj_deleteSpec(child);
+    }
+    return ok;
+}
+
+int main(int argc, const char* argv[]) {
+    std::string model_path = argc > 1 ? argv[1] : "models/tb3.xml";
+    int robots = argc > 2 ? std::stoi(argv[2]) : 8;
+    std::string out_path = argc > 3 ? argv[3] : "";
+    const int steps = 5000;
+
+    bool ok = compare_scene(model_path, 1, steps, out_path);
+    if (robots > 1) {
+        ok = compare_scene(model_path, robots, steps, "") && ok;
+    }
+    return ok ? 0 : 1;
+}
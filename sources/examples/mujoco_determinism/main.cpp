@@ -0,0 +1,87 @@
+#include <mujoco/mujoco.h>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "mujoco_determinism.hpp"
+
+// tb3 / drone をスレッド数・ペーシングを変えて走らせ、毎ステップの状態ハッシュが一致するか確認する
+// 使い方: determinism [steps] [--save prefix | --compare prefix]
+//   --save    基準条件のトレースを <prefix>_<model>.trace に保存する
+//   --compare 別ビルド（コンパイラフラグ違いなど）で保存したトレースと基準条件を比較する
+static const char* model_names[] = {"tb3", "drone"};
+static const char* model_paths[] = {"models/tb3.xml", "models/drone.xml"};
+
+static bool check_model(const std::string& name, const std::string& path, int64_t steps, const std::string& mode,
+                        const std::string& prefix) {
+    char error[1000];
+    mjModel* model = mj_loadXML(path.c_str(), nullptr, error, sizeof(error));
+    if (!model) {
+        std::cerr << "[ERROR] Failed to load model: " << path << "\n" << error << std::endl;
+        return false;
+    }
+
+    int ncpu = static_cast<int>(std::thread::hardware_concurrency());
+    DeterminismConfig reference;
+    reference.label = "reference";
+    std::vector<DeterminismConfig> configs;
+    configs.push_back({"mjThreadPool x2", 2, 1, PaceMode::Free});
+    configs.push_back({"mjThreadPool x4", 4, 1, PaceMode::Free});
+    configs.push_back({"replicas x" + std::to_string(ncpu), 0, ncpu, PaceMode::Free});
+    configs.push_back({"jitter pacing", 0, 1, PaceMode::Jitter});
+    configs.push_back({"viewer contention", 0, 1, PaceMode::Contended});
+
+    // **基準条件**
+    StateTrace expected;
+    auto start = std::chrono::steady_clock::now();
+    run_determinism_trace(model, steps, reference, expected);
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    std::cout << "[INFO] " << name << ": " << steps << " steps, " << expected.num_fields() << " state fields, "
+              << steps / elapsed.count() << " steps/s (with hashing)" << std::endl;
+
+    bool ok = true;
+    if (mode == "--save") {
+        ok = expected.save(prefix + "_" + name + ".trace");
+    } else if (mode == "--compare") {
+        StateTrace other;
+        ok = other.load(prefix + "_" + name + ".trace");
+        if (ok) {
+            Divergence d = find_divergence(other, expected);
+            ok = d.step < 0 && other.steps() == expected.steps();
+            std::cout << (ok ? "[OK]    " : "[DIFF]  ") << name << " | saved build"
+                      << (d.step >= 0 ? " | first divergence: step " + std::to_string(d.step) + ", " + d.field_name
+                                      : "")
+                      << std::endl;
+        }
+    }
+
+    // **条件を変えた実行との比較**
+    for (const DeterminismConfig& config : configs) {
+        Divergence first = run_determinism_check(model, steps, config, expected);
+        if (first.step < 0) {
+            std::cout << "[OK]    " << name << " | " << config.label << std::endl;
+        } else {
+            ok = false;
+            std::cout << "[DIFF]  " << name << " | " << config.label << " | first divergence: step " << first.step
+                      << ", " << first.field_name << std::endl;
+            report_state_difference(model, first.step, reference, config);
+        }
+    }
+
+    mj_deleteModel(model);
+    return ok;
+}
+
+int main(int argc, const char* argv[]) {
+    int64_t steps = argc > 1 ? std::stoll(argv[1]) : 100000;
+    std::string mode = argc > 2 ? argv[2] : "";
+    std::string prefix = argc > 3 ? argv[3] : "determinism";
+
+    bool ok = true;
+    for (int i = 0; i < 2; i++) {
+        ok = check_model(model_names[i], model_paths[i], steps, mode, prefix) && ok;
+    }
+    std::cout << (ok ? "[INFO] All runs are bit-identical." : "[ERROR] Determinism check failed.") << std::endl;
+    return ok ? 0 : 1;
+}
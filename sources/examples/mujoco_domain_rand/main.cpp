@@ -0,0 +1,79 @@
+#include <mujoco/mujoco.h>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include "mujoco_domain_randomizer.hpp"
+
+// tb3.xml の物理パラメータを再コンパイルせずにランダム化し、mj_loadXML による方法と時間を比較する
+// 使い方: domain_rand [model_path] [episodes]
+
+static double elapsed_us(std::chrono::steady_clock::time_point start) {
+    std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count();
+}
+
+int main(int argc, const char* argv[]) {
+    std::string model_path = argc > 1 ? argv[1] : "models/tb3.xml";
+    int episodes = argc > 2 ? std::stoi(argv[2]) : 1000;
+
+    char error[1000];
+    std::cout << "[INFO] Loading model: " << model_path << std::endl;
+    mjModel* base = mj_loadXML(model_path.c_str(), nullptr, error, sizeof(error));
+    if (!base) {
+        std::cerr << "[ERROR] Failed to load model: " << model_path << "\n" << error << std::endl;
+        return 1;
+    }
+
+    // 質量 ±20%、慣性 ±20%、摩擦 0.7〜1.3 倍、減衰 0.5〜2 倍、ギア ±10%
+    RandomizeSpec spec = {
+        {RandomizeTarget::BodyMass, "", 0.8, 1.2},
+        {RandomizeTarget::BodyInertia, "", 0.8, 1.2},
+        {RandomizeTarget::GeomFriction, "", 0.7, 1.3},
+        {RandomizeTarget::DofDamping, "", 0.5, 2.0},
+        {RandomizeTarget::ActuatorGear, "", 0.9, 1.1},
+    };
+    DomainRandomizer randomizer(base, spec, 1);
+    if (!randomizer.valid()) {
+        mj_deleteModel(base);
+        return 1;
+    }
+    mjModel* model = randomizer.model(0);
+    mjData* data = mj_makeData(model);
+
+    // 1エピソードあたりのランダム化コスト
+    double randomize_us = 0;
+    for (int e = 0; e < episodes; e++) {
+        auto start = std::chrono::steady_clock::now();
+        randomizer.randomize(0);
+        randomize_us += elapsed_us(start);
+
+        // ランダム化したモデルで短いエピソードを実行する
+        mj_resetData(model, data);
+        for (int s = 0; s < 50; s++) {
+            for (int i = 0; i < model->nu; i++) {
+                data->ctrl[i] = 0.5;
+            }
+            mj_step(model, data);
+        }
+    }
+
+    // 比較: XML を読み込み直す方法
+    int reload_count = episodes < 20 ? episodes : 20;
+    double reload_us = 0;
+    for (int e = 0; e < reload_count; e++) {
+        auto start = std::chrono::steady_clock::now();
+        mjModel* reloaded = mj_loadXML(model_path.c_str(), nullptr, error, sizeof(error));
+        reload_us += elapsed_us(start);
+        mj_deleteModel(reloaded);
+    }
+
+    std::cout << "[INFO] Randomize + mj_setConst: " << randomize_us / episodes << " us/episode" << std::endl;
+    std::cout << "[INFO] mj_loadXML: " << (reload_count > 0 ? reload_us / reload_count : 0) << " us/episode" << std::endl;
+    std::cout << "[INFO] Last episode base x: " << data->qpos[0]
+              << " | total mass: " << mj_getTotalmass(model)
+              << " (base " << mj_getTotalmass(base) << ")" << std::endl;
+
+    mj_deleteData(data);
+    mj_deleteModel(base);
+    return 0;
+}
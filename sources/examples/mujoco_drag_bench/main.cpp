@@ -0,0 +1,183 @@
+#include <mujoco/mujoco.h>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "drone_drag_plugin.hpp"
+#include "drone_hover_lqr.hpp"
+#include "mujoco_timer.hpp"
+
+// 組み込みの楕円体流体モデル (drone.xml) と hakoniwa.drone_drag プラグイン (drone_drag.xml) を比較する
+//  1. drone.xml の流体力から集中定数モデルの係数を最小二乗で推定する
+//  2. 推定した係数（ロータ抵抗なし）で同じ飛行をさせ、軌道の差と1ステップの時間を比べる
+// 使い方: drag_bench [duration_s]
+static const std::string fluid_path = "models/drone.xml";
+static const std::string plugin_path = "models/drone_drag.xml";
+
+static mjModel* load_model(const std::string& path) {
+    char error[1000];
+    mjModel* model = mj_loadXML(path.c_str(), nullptr, error, sizeof(error));
+    if (!model) {
+        std::cerr << "[ERROR] Failed to load model: " << path << "\n" << error << std::endl;
+    }
+    return model;
+}
+
+// 姿勢を初期値のまま、自由度 dof に速度 v を与えたときの受動力
+static double passive_force(const mjModel* m, mjData* d, int dof, double v) {
+    mj_resetData(m, d);
+    d->qvel[dof] = v;
+    mj_forward(m, d);
+    return d->qfrc_passive[dof];
+}
+
+// 流体モデルから軸ごとに F = -(a v + b v|v|)（回転は T = -a w）を当てはめる
+static DroneDragParams fit_params(const mjModel* m, int dofadr) {
+    DroneDragParams p = {};
+    mjData* d = mj_makeData(m);
+    for (int axis = 0; axis < 3; axis++) {
+        // 並進（フリージョイントの並進自由度はワールド座標系、初期姿勢ではボディ座標系と一致）
+        double s11 = 0, s12 = 0, s22 = 0, r1 = 0, r2 = 0;
+        for (int k = -20; k <= 20; k++) {
+            double v = 0.5 * k;
+            double f = -passive_force(m, d, dofadr + axis, v);
+            double x1 = v;
+            double x2 = v * std::fabs(v);
+            s11 += x1 * x1;
+            s12 += x1 * x2;
+            s22 += x2 * x2;
+            r1 += x1 * f;
+            r2 += x2 * f;
+        }
+        double det = s11 * s22 - s12 * s12;
+        p.linear[axis] = (r1 * s22 - r2 * s12) / det;
+        p.quadratic[axis] = (s11 * r2 - s12 * r1) / det;
+
+        // 回転（ボディ座標系）
+        double sw = 0, rw = 0;
+        for (int k = -10; k <= 10; k++) {
+            double w = 1.0 * k;
+            sw += w * w;
+            rw += w * -passive_force(m, d, dofadr + 3 + axis, w);
+        }
+        p.angular[axis] = rw / sw;
+    }
+    mj_deleteData(d);
+    return p;
+}
+
+struct FlightResult {
+    std::vector<double> positions;
+    double ns_per_step = 0;
+    double velocity_us = 0;  // mjTIMER_VELOCITY（受動力を含む）
+};
+
+// ホバリングLQRで目標を巡回させる
+static FlightResult fly(const mjModel* m, mjData* d, const DroneHoverLqr& base_controller, double duration) {
+    static const double targets[4][3] = {{2.0, 0.0, 1.0}, {2.0, 2.0, 2.0}, {0.0, 2.0, 1.0}, {0.0, 0.0, 0.5}};
+    DroneHoverLqr controller = base_controller;
+    FlightResult result;
+    int body = mj_name2id(m, mjOBJ_BODY, "drone_base");
+    const ConstJointView base = DroneHoverLqr::bind_base(m, d);
+    int64_t steps = static_cast<int64_t>(duration / m->opt.timestep);
+    int64_t per_target = steps / 4 > 0 ? steps / 4 : 1;
+    std::memset(d->timer, 0, sizeof(d->timer));
+    auto start = std::chrono::steady_clock::now();
+    for (int64_t i = 0; i < steps; i++) {
+        if (i % per_target == 0) {
+            controller.set_target(targets[(i / per_target) % 4], 0.0);
+        }
+        controller.compute(base, d->ctrl);
+        mj_step(m, d);
+        result.positions.insert(result.positions.end(), d->xpos + 3 * body, d->xpos + 3 * body + 3);
+    }
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    result.ns_per_step = elapsed.count() / static_cast<double>(steps);
+    result.velocity_us = mujoco_timer_average_us(d, mjTIMER_VELOCITY);
+    return result;
+}
+
+int main(int argc, const char* argv[]) {
+    double duration = argc > 1 ? std::stod(argv[1]) : 20.0;
+    if (!register_drone_drag_plugin()) {
+        return 1;
+    }
+    enable_mujoco_timers();
+
+    mjModel* fluid = load_model(fluid_path);
+    mjModel* plugin = fluid ? load_model(plugin_path) : nullptr;
+    if (!fluid || !plugin) {
+        if (fluid) {
+            mj_deleteModel(fluid);
+        }
+        return 1;
+    }
+
+    // **1. 係数の推定**
+    int base = mj_name2id(fluid, mjOBJ_BODY, "drone_base");
+    int dofadr = fluid->jnt_dofadr[fluid->body_jntadr[base]];
+    DroneDragParams fitted = fit_params(fluid, dofadr);
+    fitted.rotor = 0;
+    std::cout << "[INFO] Fitted from " << fluid_path << ":" << std::endl;
+    std::cout << "  <config key=\"linear\" value=\"" << fitted.linear[0] << " " << fitted.linear[1] << " "
+              << fitted.linear[2] << "\"/>" << std::endl;
+    std::cout << "  <config key=\"quadratic\" value=\"" << fitted.quadratic[0] << " " << fitted.quadratic[1] << " "
+              << fitted.quadratic[2] << "\"/>" << std::endl;
+    std::cout << "  <config key=\"angular\" value=\"" << fitted.angular[0] << " " << fitted.angular[1] << " "
+              << fitted.angular[2] << "\"/>" << std::endl;
+
+    // **2. 同じ飛行での比較**
+    DroneHoverLqr controller;
+    if (!controller.build(fluid, std::thread::hardware_concurrency())) {
+        std::cerr << "[ERROR] Failed to build hover controller" << std::endl;
+        mj_deleteModel(plugin);
+        mj_deleteModel(fluid);
+        return 1;
+    }
+    mjData* fluid_data = mj_makeData(fluid);
+    mjData* plugin_data = mj_makeData(plugin);
+    int plugin_body = mj_name2id(plugin, mjOBJ_BODY, "drone_base");
+    int instance = plugin_body >= 0 ? plugin->body_plugin[plugin_body] : -1;
+    DroneDragParams* params = drone_drag_params(plugin, plugin_data, instance);
+    if (!params) {
+        std::cerr << "[ERROR] drone_base has no " << kDroneDragPluginName << " instance" << std::endl;
+        mj_deleteData(plugin_data);
+        mj_deleteData(fluid_data);
+        mj_deleteModel(plugin);
+        mj_deleteModel(fluid);
+        return 1;
+    }
+    DroneDragParams configured = *params;
+
+    FlightResult reference = fly(fluid, fluid_data, controller, duration);
+    *params = fitted;
+    mj_resetData(plugin, plugin_data);
+    FlightResult lumped = fly(plugin, plugin_data, controller, duration);
+    *params = configured;
+    mj_resetData(plugin, plugin_data);
+    FlightResult with_rotor = fly(plugin, plugin_data, controller, duration);
+
+    auto max_error = [&](const FlightResult& r) {
+        double e = 0;
+        for (size_t i = 0; i < r.positions.size(); i++) {
+            e = std::fmax(e, std::fabs(r.positions[i] - reference.positions[i]));
+        }
+        return e;
+    };
+    std::cout << "[INFO] ellipsoid fluid (built-in): " << reference.ns_per_step << " ns/step | fwdVelocity "
+              << reference.velocity_us << " us" << std::endl;
+    std::cout << "[INFO] drone_drag (fitted):        " << lumped.ns_per_step << " ns/step | fwdVelocity "
+              << lumped.velocity_us << " us | max position error " << max_error(lumped) << " m" << std::endl;
+    std::cout << "[INFO] drone_drag (XML + rotor):   " << with_rotor.ns_per_step << " ns/step | fwdVelocity "
+              << with_rotor.velocity_us << " us | max position error " << max_error(with_rotor) << " m" << std::endl;
+    std::cout << "[INFO] Speedup: " << reference.ns_per_step / lumped.ns_per_step << "x per step" << std::endl;
+
+    mj_deleteData(plugin_data);
+    mj_deleteData(fluid_data);
+    mj_deleteModel(plugin);
+    mj_deleteModel(fluid);
+    return 0;
+}
@@ -1,84 +1,64 @@
 #include "mujoco_debug.hpp"
+#include "drone_hover_lqr.hpp"
 #include "mujoco_viewer.hpp"
+#include "mujoco_input_recorder.hpp"
+#include "mujoco_watchdog.hpp"
+#include "mujoco_adaptive_step.hpp"
 #include <mujoco/mujoco.h>
 #include <iostream>
 #include <iomanip>
 #include <string>
 #include <thread>
 #include <mutex>
-#include <vector>
 
 // MuJoCoのモデルとデータ
 static mjModel* mujoco_model;
 static mjData* mujoco_data;
 static const std::string model_path = "models/drone.xml";
+static const std::string record_path = "drone_inputs.mjrec";
 
 static std::mutex data_mutex;
 
-// プロペラの制御設定
-const char* prop_names[] = {"prop1", "prop2", "prop3", "prop4"};
-std::vector<double> prop_thrust(4, 0.0);
-std::vector<double> prop_torque(4, 0.0);
-
-// **mjcb_control コールバック関数**
-void my_control_callback(const mjModel* model, mjData* data) {
-    //std::lock_guard<std::mutex> lock(data_mutex);
-
-    for (int i = 0; i < 4; i++) {
-        int body_id = mj_name2id(model, mjOBJ_BODY, prop_names[i]);
-        if (body_id == -1) {
-            std::cerr << "[ERROR] Body not found: " << prop_names[i] << std::endl;
-            continue;
-        }
-        //std::cout << "[INFO] Applying control to: " << prop_names[i] << std::endl;
-
-        // ボディ座標系での推力とトルク
-        double F_body[3] = {0, 0, prop_thrust[i]};  // Z軸方向推力
-        double T_body[3] = {0, 0, prop_torque[i]}; // 偶数は時計回り、奇数は反時計回り
-
-        // ワールド座標系の回転行列（3×3）
-        double* R = data->xmat + 9 * body_id;
-
-        // ボディ座標系 → ワールド座標系変換
-        double F_world[3] = {
-            R[0] * F_body[0] + R[1] * F_body[1] + R[2] * F_body[2],
-            R[3] * F_body[0] + R[4] * F_body[1] + R[5] * F_body[2],
-            R[6] * F_body[0] + R[7] * F_body[1] + R[8] * F_body[2]
-        };
-
-        double T_world[3] = {
-            R[0] * T_body[0] + R[1] * T_body[1] + R[2] * T_body[2],
-            R[3] * T_body[0] + R[4] * T_body[1] + R[5] * T_body[2],
-            R[6] * T_body[0] + R[7] * T_body[1] + R[8] * T_body[2]
-        };
-
-        // `xfrc_applied` に適用
-        for (int j = 0; j < 3; j++) {
-            data->xfrc_applied[body_id * 6 + j] = F_world[j];
-            data->xfrc_applied[body_id * 6 + 3 + j] = T_world[j];
-        }
-    }
-}
+// ホバリングLQR制御器と目標位置
+static DroneHoverLqr hover_controller;
+static const double target_pos[3] = {0.0, 0.0, 0.5};
+static const double target_yaw = 0.0;
 
 // **シミュレーションスレッド**
-void simulation_thread(mjModel* model, mjData* data, bool& running_flag, std::mutex& mutex) {
+void simulation_thread(mjModel* model, mjData* data, bool& running_flag, std::mutex& mutex, InputRecorder& recorder,
+                       bool adaptive) {
     double simulation_timestep = model->opt.timestep;
-    std::cout << "[INFO] Simulation timestep: " << simulation_timestep << " sec" << std::endl;
+    std::cout << "[INFO] Simulation timestep: " << simulation_timestep << " sec"
+              << (adaptive ? " (adaptive)" : "") << std::endl;
+
+    // 発散したら直前の状態へ巻き戻し、しばらく timestep を縮めて続行する（固定 timestep の場合）
+    StepWatchdog watchdog(model, data);
+    // 局所誤差に応じて timestep を伸び縮みさせる（--adaptive の場合）
+    AdaptiveStepOptions adaptive_options;
+    adaptive_options.max_timestep = 10 * model->opt.timestep;
+    AdaptiveStepper stepper(adaptive_options);
+    // 巻き戻しは同じ mjData へ状態を書き戻すだけなので、ビューは1回だけ束縛すればよい
+    const ConstJointView base = DroneHoverLqr::bind_base(model, data);
 
     while (running_flag) {
         auto start = std::chrono::steady_clock::now();
 
         {
             std::lock_guard<std::mutex> lock(mutex);
-            prop_thrust[0] = 1.2;
-            prop_thrust[1] = 1.2;
-            prop_thrust[2] = 1.2;
-            prop_thrust[3] = 1.2;
-            prop_torque[0] = 0.01;
-            prop_torque[1] = 0.0;
-            prop_torque[2] = 0.0;
-            prop_torque[3] = 0.0;
-            mj_step(model, data);
+            hover_controller.compute(base, data->ctrl);
+            recorder.record(data);  // ビューアからの外乱 (xfrc_applied) も含めて入力だけを記録
+            bool rolled_back = false;
+            if (adaptive) {
+                simulation_timestep = stepper.step(model, data);
+            } else {
+                simulation_timestep = model->opt.timestep;  // 回復中は縮めた timestep でペーシングする
+                mj_step(model, data);
+                rolled_back = watchdog.after_step(data) == WatchdogStatus::RolledBack;
+            }
+            recorder.record_timestep(simulation_timestep);
+            if (rolled_back) {
+                recorder.record_rewind(data);  // 巻き戻した状態から再生を続けられるようにする
+            }
         }
 
         auto end = std::chrono::steady_clock::now();
@@ -92,7 +72,10 @@ void simulation_thread(mjModel* model, mjData* data, bool& running_flag, std::mu
 }
 
 // **メイン関数**
-int main() {
+// 使い方: drone [--adaptive]
+int main(int argc, const char* argv[]) {
+    const bool adaptive = argc > 1 && std::string(argv[1]) == "--adaptive";
+
     // **MuJoCoモデルの読み込み**
     char error[1000];
     std::cout << "[INFO] Loading model: " << model_path << std::endl;
@@ -110,18 +93,31 @@ int main() {
     // **初期状態を正しく計算する**
     mj_forward(mujoco_model, mujoco_data);
     
-    // **コールバック登録**
-    mjcb_control = my_control_callback;
+    // **ホバリングLQRのゲインテーブル作成**
+    std::cout << "[INFO] Building hover LQR gain table." << std::endl;
+    if (!hover_controller.build(mujoco_model, std::thread::hardware_concurrency())) {
+        mj_deleteData(mujoco_data);
+        mj_deleteModel(mujoco_model);
+        return 1;
+    }
+    hover_controller.set_target(target_pos, target_yaw);
 
     // **シミュレーションの実行**
     const double dt = mujoco_model->opt.timestep;
     std::cout << "[INFO] Starting simulation." << std::endl;
     
+    // **入力の記録（replay で再シミュレーションできる）**
+    InputRecorder recorder(mujoco_model);
+    recorder.open(record_path);
+
     bool running_flag = true;
-    std::thread sim_thread(simulation_thread, mujoco_model, mujoco_data, std::ref(running_flag), std::ref(data_mutex));
+    std::thread sim_thread(simulation_thread, mujoco_model, mujoco_data, std::ref(running_flag), std::ref(data_mutex),
+                           std::ref(recorder), adaptive);
     viewer_thread(mujoco_model, mujoco_data, std::ref(running_flag), std::ref(data_mutex));
     running_flag = false;
     sim_thread.join();
+    recorder.close(mujoco_data);
+    std::cout << "[INFO] Recorded " << recorder.steps() << " steps to " << record_path << std::endl;
     // **リソース解放**
     std::cout << "[INFO] Cleaning up resources." << std::endl;
     mj_deleteData(mujoco_data);
@@ -0,0 +1,103 @@
+#include <mujoco/mujoco.h>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "mujoco_ilqr.hpp"
+
+// ドローンの機動を iLQR で計画し（オフライン）、続けて後退ホライズン制御で追従する
+static const std::string model_path = "models/drone.xml";
+
+// 計画する機動: 原点から (1.0, 0.5, 1.0) へ移動しながら 90 度ヨー回転
+static const double goal_pos[3] = {1.0, 0.5, 1.0};
+static const double goal_yaw = M_PI / 2;
+
+static double elapsed_ms(std::chrono::steady_clock::time_point start) {
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count();
+}
+
+int main(int argc, const char* argv[]) {
+    int nworker = argc > 1 ? std::stoi(argv[1]) : static_cast<int>(std::thread::hardware_concurrency());
+    int mpc_steps = argc > 2 ? std::stoi(argv[2]) : 100;
+
+    char error[1000];
+    std::cout << "[INFO] Loading model: " << model_path << std::endl;
+    mjModel* model = mj_loadXML(model_path.c_str(), nullptr, error, sizeof(error));
+    if (!model) {
+        std::cerr << "[ERROR] Failed to load model: " << model_path << "\n" << error << std::endl;
+        return 1;
+    }
+    if (model->nu == 0) {
+        std::cerr << "[ERROR] Model has no actuators: " << model_path << std::endl;
+        mj_deleteModel(model);
+        return 1;
+    }
+    mjData* data = mj_makeData(model);
+    mj_forward(model, data);
+
+    const int nx = 2 * model->nv + model->na;
+    double hover_thrust = mj_getTotalmass(model) * -model->opt.gravity[2] / model->nu;
+
+    // コスト: 位置・姿勢を重視し、終端では速度も抑える
+    IlqrCost cost;
+    cost.Q.assign(nx, 0.1);
+    cost.Qf.assign(nx, 10.0);
+    for (int i = 0; i < 3; i++) {
+        cost.Q[i] = 1.0;
+        cost.Qf[i] = 100.0;
+        cost.Qf[3 + i] = 50.0;
+    }
+    cost.R.assign(model->nu, 0.1);
+    cost.u_ref.assign(model->nu, hover_thrust);
+    cost.goal_qpos.assign(model->qpos0, model->qpos0 + model->nq);
+    for (int i = 0; i < 3; i++) {
+        cost.goal_qpos[i] = goal_pos[i];
+    }
+    cost.goal_qpos[3] = std::cos(0.5 * goal_yaw);
+    cost.goal_qpos[4] = 0;
+    cost.goal_qpos[5] = 0;
+    cost.goal_qpos[6] = std::sin(0.5 * goal_yaw);
+
+    IlqrOptions options;
+    options.horizon = 100;
+    options.nworker = nworker;
+    IlqrSolver solver(model, options, cost);
+
+    // オフライン計画
+    std::vector<mjtNum> U;
+    auto start = std::chrono::steady_clock::now();
+    int iter = solver.solve(data, U);
+    double plan_ms = elapsed_ms(start);
+    const std::vector<mjtNum>& qpos = solver.qpos_trajectory();
+    const mjtNum* final_pos = qpos.data() + options.horizon * model->nq;
+    std::cout << "[INFO] Workers: " << nworker
+              << " | Offline plan: " << iter << " iterations, " << plan_ms << " ms"
+              << " | cost: " << solver.cost() << std::endl;
+    std::cout << "[INFO] Planned final position: (" << final_pos[0] << ", " << final_pos[1] << ", "
+              << final_pos[2] << ")" << std::endl;
+
+    // 後退ホライズン制御（各ステップで数回だけ反復し、先頭の入力を適用）
+    double solve_ms = 0;
+    for (int step = 0; step < mpc_steps; step++) {
+        start = std::chrono::steady_clock::now();
+        solver.solve(data, U, 3);
+        solve_ms += elapsed_ms(start);
+        mju_copy(data->ctrl, U.data(), model->nu);
+        mj_step(model, data);
+        solver.shift(U);
+    }
+    double err = 0;
+    for (int i = 0; i < 3; i++) {
+        err += (data->qpos[i] - goal_pos[i]) * (data->qpos[i] - goal_pos[i]);
+    }
+    std::cout << "[INFO] Receding horizon: " << mpc_steps << " steps"
+              << " | avg solve: " << (mpc_steps > 0 ? solve_ms / mpc_steps : 0) << " ms"
+              << " | position error: " << std::sqrt(err) << " m" << std::endl;
+
+    mj_deleteData(data);
+    mj_deleteModel(model);
+    return 0;
+}
@@ -0,0 +1,63 @@
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <string>
+#include "mujoco_shm_env.hpp"
+
+// env_server に接続し、学習器の代わりに乱数の行動で環境を進めるクライアント
+// 使い方: env_client [shm_name] [steps]
+
+int main(int argc, const char* argv[]) {
+    std::string shm_name = argc > 1 ? argv[1] : "/mujoco_env";
+    int steps = argc > 2 ? std::stoi(argv[2]) : 10000;
+
+    ShmEnvRegion region;
+    if (!region.open(shm_name)) {
+        return 1;
+    }
+    ShmEnvHeader* header = region.header();
+    const int num_envs = header->num_envs;
+    const int nu = header->nu;
+    const int nobs = header->nobs;
+    std::cout << "[INFO] Connected to " << shm_name << " (envs=" << num_envs
+              << ", nobs=" << nobs << ", nu=" << nu << ")" << std::endl;
+
+    if (!shm_env_request(header, kShmEnvReset, 5000)) {
+        std::cerr << "[ERROR] Server did not respond to reset" << std::endl;
+        return 1;
+    }
+
+    std::mt19937 rng(0);
+    std::uniform_real_distribution<double> dist(-1.0, 1.0);
+    double* actions = region.actions();
+    const double* rewards = region.rewards();
+    const uint8_t* dones = region.dones();
+
+    double reward_sum = 0;
+    long episodes = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int s = 0; s < steps; s++) {
+        // 行動は共有メモリへ直接書き込む
+        for (int i = 0; i < num_envs * nu; i++) {
+            actions[i] = dist(rng);
+        }
+        if (!shm_env_request(header, kShmEnvStep, 5000)) {
+            std::cerr << "[ERROR] Server did not respond at step " << s << std::endl;
+            return 1;
+        }
+        for (int i = 0; i < num_envs; i++) {
+            reward_sum += rewards[i];
+            episodes += dones[i];
+        }
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    double env_steps = static_cast<double>(num_envs) * steps;
+    std::cout << "[INFO] Steps: " << steps << " | Elapsed: " << elapsed.count() << " s"
+              << " | env-steps/min: " << env_steps / elapsed.count() * 60
+              << " | round trip: " << elapsed.count() / steps * 1e6 << " us" << std::endl;
+    std::cout << "[INFO] Episodes finished: " << episodes << " | reward sum: " << reward_sum << std::endl;
+
+    shm_env_request(header, kShmEnvShutdown, 1000);
+    return 0;
+}
@@ -0,0 +1,88 @@
+#include <mujoco/mujoco.h>
+#include <csignal>
+#include <iostream>
+#include <string>
+#include "mujoco_shm_env.hpp"
+#include "mujoco_vec_env.hpp"
+
+// ベクトル化環境をホストし、共有メモリ経由で別プロセスの学習器から駆動させるサーバ
+// 使い方: env_server [model_path] [num_envs] [shm_name] [nworker]
+
+static volatile std::sig_atomic_t stop_requested = 0;
+
+static void handle_signal(int) {
+    stop_requested = 1;
+}
+
+int main(int argc, const char* argv[]) {
+    std::string model_path = argc > 1 ? argv[1] : "models/tb3.xml";
+    int num_envs = argc > 2 ? std::stoi(argv[2]) : 64;
+    std::string shm_name = argc > 3 ? argv[3] : "/mujoco_env";
+    int nworker = argc > 4 ? std::stoi(argv[4]) : 1;
+
+    char error[1000];
+    std::cout << "[INFO] Loading model: " << model_path << std::endl;
+    mjModel* model = mj_loadXML(model_path.c_str(), nullptr, error, sizeof(error));
+    if (!model) {
+        std::cerr << "[ERROR] Failed to load model: " << model_path << "\n" << error << std::endl;
+        return 1;
+    }
+
+    ShmEnvRegion region;
+    if (!region.create(shm_name, num_envs, VecEnv::observation_dim(model), model->nu)) {
+        mj_deleteModel(model);
+        return 1;
+    }
+
+    // VecEnv は model を参照し続けるため、model より先に破棄する
+    {
+        // 観測・報酬・終了フラグは共有メモリへ直接書き込む
+        VecEnvOptions options;
+        options.num_envs = num_envs;
+        options.nworker = nworker;
+        VecEnvBuffers buffers;
+        buffers.observations = region.observations();
+        buffers.rewards = region.rewards();
+        buffers.dones = region.dones();
+        VecEnv env(model, options, buffers);
+
+        std::signal(SIGINT, handle_signal);
+        std::signal(SIGTERM, handle_signal);
+        std::cout << "[INFO] Serving " << num_envs << " envs on " << shm_name
+                  << " (nobs=" << env.observation_dim() << ", nu=" << env.action_dim() << ")" << std::endl;
+
+        ShmEnvHeader* header = region.header();
+        uint32_t handled = header->request.seq.load(std::memory_order_acquire);
+        long steps = 0;
+        bool running = true;
+        while (running && !stop_requested) {
+            // タイムアウト付きで待ち、シグナルによる停止要求を確認できるようにする
+            if (!shm_env_wait(&header->request, handled, 100)) {
+                continue;
+            }
+            handled = header->request.seq.load(std::memory_order_acquire);
+            switch (header->command) {
+                case kShmEnvStep:
+                    env.step(region.actions());
+                    steps++;
+                    break;
+                case kShmEnvReset:
+                    env.reset();
+                    break;
+                case kShmEnvShutdown:
+                    running = false;
+                    break;
+                default:
+                    std::cerr << "[ERROR] Unknown command: " << header->command << std::endl;
+                    break;
+            }
+            header->response.seq.store(handled, std::memory_order_release);
+            shm_env_wake(&header->response);
+        }
+
+        std::cout << "[INFO] Server stopped after " << steps << " steps." << std::endl;
+    }
+
+    mj_deleteModel(model);
+    return 0;
+}
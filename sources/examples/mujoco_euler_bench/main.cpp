@@ -0,0 +1,153 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include <mujoco/mujoco.h>
+#include "mujoco_euler.hpp"
+#include "mujoco_state_view.hpp"
+
+// quat_to_euler_batch の精度（スカラー版との差）と変換速度を測る
+// 入力は自由剛体を並べたモデルの mjData::xquat を BodyBatchView で連続配列として読む
+// 使い方: euler_bench [nbody] [iterations]
+
+// 角度差を [-π, π] に折り返す（±π 付近のロール・ヨーは符号が反転しうる）
+static double angle_diff(double a, double b) {
+    return std::abs(std::remainder(a - b, 2 * M_PI));
+}
+
+// 一様ランダムな姿勢に、ジンバルロック付近・軸回りの回転などの境界ケースを混ぜる
+static std::vector<double> make_quats(int n, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::normal_distribution<double> normal(0.0, 1.0);
+    std::uniform_real_distribution<double> angle(-M_PI, M_PI);
+    std::vector<double> quat(4 * n);
+    for (int i = 0; i < n; i++) {
+        double* q = &quat[4 * i];
+        switch (i % 8) {
+            case 0: {
+                // ピッチ ±90度付近
+                double pitch = (i % 16 == 0 ? 1 : -1) * (M_PI / 2 - 1e-9 * (i % 7));
+                double yaw = angle(rng);
+                q[0] = std::cos(yaw / 2) * std::cos(pitch / 2);
+                q[1] = -std::sin(yaw / 2) * std::sin(pitch / 2);
+                q[2] = std::cos(yaw / 2) * std::sin(pitch / 2);
+                q[3] = std::sin(yaw / 2) * std::cos(pitch / 2);
+                break;
+            }
+            case 1: {
+                // ヨー軸回りのみ（平面移動ロボット）
+                double yaw = angle(rng);
+                q[0] = std::cos(yaw / 2);
+                q[1] = 0;
+                q[2] = 0;
+                q[3] = std::sin(yaw / 2);
+                break;
+            }
+            default:
+                for (int k = 0; k < 4; k++) {
+                    q[k] = normal(rng);
+                }
+                break;
+        }
+        double norm = std::sqrt(q[0] * q[0] + q[1] * q[1] + q[2] * q[2] + q[3] * q[3]);
+        for (int k = 0; k < 4; k++) {
+            q[k] /= norm;
+        }
+    }
+    return quat;
+}
+
+// 自由剛体を nbody 個並べたモデルを作る（剛体 1..nbody が連続した範囲になる）
+static mjModel* make_free_bodies(int nbody) {
+    mjSpec* spec = mj_makeSpec();
+    mjsBody* world = mjs_findBody(spec, "world");
+    for (int i = 0; i < nbody; i++) {
+        mjsBody* body = mjs_addBody(world, nullptr);
+        mjs_addFreeJoint(body);
+        mjsGeom* geom = mjs_addGeom(body, nullptr);
+        geom->type = mjGEOM_SPHERE;
+        geom->size[0] = 0.1;
+    }
+    mjModel* model = mj_compile(spec, nullptr);
+    if (!model) {
+        std::cerr << "[ERROR] Failed to compile model: " << mjs_getError(spec) << std::endl;
+    }
+    mj_deleteSpec(spec);
+    return model;
+}
+
+int main(int argc, const char* argv[]) {
+    int nbody = argc > 1 ? std::stoi(argv[1]) : 10000;
+    int iterations = argc > 2 ? std::stoi(argv[2]) : 1000;
+
+    mjModel* model = make_free_bodies(nbody);
+    if (!model) {
+        return 1;
+    }
+    mjData* data = mj_makeData(model);
+
+    // 姿勢を各剛体のフリージョイントに書き込み、順運動学で xquat を求める
+    std::vector<double> poses = make_quats(nbody, 1);
+    for (int i = 0; i < nbody; i++) {
+        JointView joint = JointView::bind(model, data, i);
+        mju_copy4(joint.qpos().data() + 3, &poses[4 * i]);
+    }
+    mj_kinematics(model, data);
+    const ConstBodyBatchView bodies = ConstBodyBatchView::bind(model, data, 1, nbody);
+    const mjtNum* quat = bodies.xquat_data();
+    std::vector<double> roll(nbody), pitch(nbody), yaw(nbody);
+    std::vector<double> ref_roll(nbody), ref_pitch(nbody), ref_yaw(nbody);
+
+    // **精度の確認**
+    quat_to_euler_batch(quat, nbody, roll.data(), pitch.data(), yaw.data());
+    // ジンバルロック付近ではロールとヨーが定まらない（元の式も atan2(0, 0) になる）ため、
+    // ピッチは全件、ロールとヨーはロックから離れた姿勢だけで比較する
+    double max_err[3] = {0, 0, 0};
+    for (int i = 0; i < nbody; i++) {
+        quat_to_euler(quat + 4 * i, ref_roll[i], ref_pitch[i], ref_yaw[i]);
+        max_err[1] = std::max(max_err[1], angle_diff(pitch[i], ref_pitch[i]));
+        if (std::abs(ref_pitch[i]) > M_PI / 2 - 1e-3) {
+            continue;
+        }
+        max_err[0] = std::max(max_err[0], angle_diff(roll[i], ref_roll[i]));
+        max_err[2] = std::max(max_err[2], angle_diff(yaw[i], ref_yaw[i]));
+    }
+    std::cout << "[INFO] Batch kernel: " << (quat_to_euler_batch_is_simd() ? "AVX2" : "scalar") << std::endl;
+    std::cout << "[INFO] Max error vs scalar (rad) | roll: " << max_err[0] << ", pitch: " << max_err[1]
+              << ", yaw: " << max_err[2] << std::endl;
+    const double tolerance = 1e-9;
+    bool accurate = max_err[0] < tolerance && max_err[1] < tolerance && max_err[2] < tolerance;
+    if (!accurate) {
+        std::cerr << "[ERROR] Batch conversion exceeds tolerance " << tolerance << std::endl;
+    }
+
+    // **速度の比較**
+    double checksum = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int it = 0; it < iterations; it++) {
+        for (int i = 0; i < nbody; i++) {
+            quat_to_euler(quat + 4 * i, ref_roll[i], ref_pitch[i], ref_yaw[i]);
+        }
+        checksum += ref_roll[it % nbody];
+    }
+    std::chrono::duration<double> scalar_s = std::chrono::steady_clock::now() - start;
+
+    start = std::chrono::steady_clock::now();
+    for (int it = 0; it < iterations; it++) {
+        quat_to_euler_batch(quat, nbody, roll.data(), pitch.data(), yaw.data());
+        checksum += roll[it % nbody];
+    }
+    std::chrono::duration<double> batch_s = std::chrono::steady_clock::now() - start;
+
+    double count = static_cast<double>(nbody) * iterations;
+    std::cout << "[INFO] Scalar: " << scalar_s.count() / count * 1e9 << " ns/quat" << std::endl;
+    std::cout << "[INFO] Batch: " << batch_s.count() / count * 1e9 << " ns/quat"
+              << " | speedup: " << scalar_s.count() / batch_s.count() << "x" << std::endl;
+    std::cout << "[INFO] (checksum " << checksum << ")" << std::endl;
+    mj_deleteData(data);
+    mj_deleteModel(model);
+    return accurate ? 0 : 1;
+}
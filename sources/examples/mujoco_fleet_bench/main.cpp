@@ -0,0 +1,104 @@
+#include <mujoco/mujoco.h>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "mujoco_fleet_builder.hpp"
+
+// N 台の tb3 を進めるコストを比較する
+//  - separate: ロボットごとに mjData を持ち、1台ずつ mj_step（従来の方法）
+//  - isolated: 1つのモデルに N 台（ロボット同士は接触しない）を並べて1回の mj_step
+//  - shared:   1つのモデルに N 台（ロボット同士も接触する）を並べて1回の mj_step
+// 使い方: fleet_bench [model_path] [steps] [N ...]
+static void robot_ctrl(mjtNum* ctrl, int nu, int index, double t) {
+    for (int i = 0; i < nu; i++) {
+        ctrl[i] = 2.0 + 1.5 * std::sin(t + 0.3 * index + i);
+    }
+}
+
+static double elapsed_us(std::chrono::steady_clock::time_point start) {
+    std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count();
+}
+
+static double run_separate(const std::string& path, int robots, int steps) {
+    char error[1000];
+    mjModel* model = mj_loadXML(path.c_str(), nullptr, error, sizeof(error));
+    if (!model) {
+        std::cerr << "[ERROR] Failed to load model: " << path << "\n" << error << std::endl;
+        return -1;
+    }
+    std::vector<mjData*> datas(robots);
+    for (mjData*& d : datas) {
+        d = mj_makeData(model);
+    }
+    auto start = std::chrono::steady_clock::now();
+    for (int s = 0; s < steps; s++) {
+        for (int r = 0; r < robots; r++) {
+            robot_ctrl(datas[r]->ctrl, model->nu, r, datas[r]->time);
+            mj_step(model, datas[r]);
+        }
+    }
+    double us = elapsed_us(start);
+    for (mjData* d : datas) {
+        mj_deleteData(d);
+    }
+    mj_deleteModel(model);
+    return us / (static_cast<double>(steps) * robots);
+}
+
+static double run_fleet(const std::string& path, int robots, int steps, FleetMode mode, int* ncon) {
+    FleetOptions options;
+    options.robots = robots;
+    options.mode = mode;
+    FleetBuilder fleet;
+    if (!fleet.build(path, options)) {
+        return -1;
+    }
+    const mjModel* model = fleet.model();
+    mjData* data = mj_makeData(model);
+    long long contacts = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int s = 0; s < steps; s++) {
+        for (int r = 0; r < robots; r++) {
+            robot_ctrl(fleet.ctrl(data, r), fleet.robot(r).nu, r, data->time);
+        }
+        mj_step(model, data);
+        contacts += data->ncon;
+    }
+    double us = elapsed_us(start);
+    *ncon = static_cast<int>(contacts / steps);
+    mj_deleteData(data);
+    return us / (static_cast<double>(steps) * robots);
+}
+
+int main(int argc, const char* argv[]) {
+    std::string model_path = argc > 1 ? argv[1] : "models/tb3.xml";
+    int steps = argc > 2 ? std::stoi(argv[2]) : 1000;
+    std::vector<int> sizes;
+    for (int i = 3; i < argc; i++) {
+        sizes.push_back(std::stoi(argv[i]));
+    }
+    if (sizes.empty()) {
+        sizes = {1, 10, 50, 100, 200};
+    }
+
+    std::cout << "[INFO] us per robot-step (" << steps << " steps)" << std::endl;
+    std::cout << std::setw(6) << "N" << std::setw(12) << "separate" << std::setw(12) << "isolated" << std::setw(8)
+              << "ncon" << std::setw(12) << "shared" << std::setw(8) << "ncon" << std::endl;
+    for (int n : sizes) {
+        int ncon_isolated = 0, ncon_shared = 0;
+        double separate = run_separate(model_path, n, steps);
+        double isolated = run_fleet(model_path, n, steps, FleetMode::Isolated, &ncon_isolated);
+        double shared = run_fleet(model_path, n, steps, FleetMode::SharedArena, &ncon_shared);
+        if (separate < 0 || isolated < 0 || shared < 0) {
+            return 1;
+        }
+        std::cout << std::fixed << std::setprecision(2) << std::setw(6) << n << std::setw(12) << separate
+                  << std::setw(12) << isolated << std::setw(8) << ncon_isolated << std::setw(12) << shared
+                  << std::setw(8) << ncon_shared << std::endl;
+    }
+    return 0;
+}
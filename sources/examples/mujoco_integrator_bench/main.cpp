@@ -0,0 +1,84 @@
+#include <mujoco/mujoco.h>
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "drone_hover_lqr.hpp"
+#include "mujoco_integrator_sweep.hpp"
+
+// 積分器 (Euler / implicit / implicitfast / RK4) と timestep を変えて tb3 / drone のコストと精度を測り、
+// パレート表と「精度の上限を満たす最も安い組み合わせ」を出力する
+// 使い方: integrator_bench [max_error_m] [duration_s]
+
+static const std::vector<int> integrators = {mjINT_EULER, mjINT_IMPLICIT, mjINT_IMPLICITFAST, mjINT_RK4};
+static const std::vector<double> timesteps = {0.001, 0.002, 0.004, 0.005, 0.01, 0.02, 0.04};
+
+static void report(const std::string& name, const mjModel* model, const std::vector<SweepResult>& results,
+                   double max_error) {
+    std::cout << "\n[INFO] " << name << " (current: " << integrator_name(model->opt.integrator)
+              << ", timestep " << model->opt.timestep << ")" << std::endl;
+    print_sweep_table(results, std::cout);
+    const SweepResult* best = cheapest_within(results, max_error);
+    if (best) {
+        std::cout << "[INFO] Cheapest within " << max_error << " m: integrator=\"" << integrator_name(best->integrator)
+                  << "\" timestep=\"" << best->timestep << "\"" << std::endl;
+    } else {
+        std::cout << "[INFO] No configuration within " << max_error << " m" << std::endl;
+    }
+}
+
+static mjModel* load_model(const std::string& path) {
+    char error[1000];
+    mjModel* model = mj_loadXML(path.c_str(), nullptr, error, sizeof(error));
+    if (!model) {
+        std::cerr << "[ERROR] Failed to load model: " << path << "\n" << error << std::endl;
+    }
+    return model;
+}
+
+int main(int argc, const char* argv[]) {
+    double max_error = argc > 1 ? std::stod(argv[1]) : 0.01;
+    SweepOptions options;
+    options.duration = argc > 2 ? std::stod(argv[2]) : 5.0;
+
+    // **tb3: 左右のモーターに周期の異なる正弦波を入れて旋回させる**
+    mjModel* tb3 = load_model("models/tb3.xml");
+    if (!tb3) {
+        return 1;
+    }
+    SweepCtrlFn tb3_ctrl = [](const mjModel* m, const mjData* d, mjtNum* ctrl) {
+        for (int i = 0; i < m->nu; i++) {
+            ctrl[i] = 5.0 * std::sin(2.0 * M_PI * 0.2 * (i + 1) * d->time);
+        }
+    };
+    report("tb3", tb3, run_integrator_sweep(tb3, integrators, timesteps, tb3_ctrl, options), max_error);
+    mj_deleteModel(tb3);
+
+    // **drone: ホバリングLQRで離れた目標位置へ移動させる（閉ループ）**
+    mjModel* drone = load_model("models/drone.xml");
+    if (!drone) {
+        return 1;
+    }
+    DroneHoverLqr controller;
+    if (!controller.build(drone, std::thread::hardware_concurrency())) {
+        std::cerr << "[ERROR] Failed to build hover controller" << std::endl;
+        mj_deleteModel(drone);
+        return 1;
+    }
+    const double target[3] = {0.5, -0.3, 1.0};
+    controller.set_target(target, 0.5);
+    // スイープは設定ごとに mjData を作り直すので、mjData が変わったときだけ束縛し直す
+    const mjData* bound_data = nullptr;
+    ConstJointView base;
+    SweepCtrlFn drone_ctrl = [&controller, &bound_data, &base](const mjModel* m, const mjData* d, mjtNum* ctrl) {
+        if (d != bound_data) {
+            base = DroneHoverLqr::bind_base(m, d);
+            bound_data = d;
+        }
+        controller.compute(base, ctrl);
+    };
+    report("drone", drone, run_integrator_sweep(drone, integrators, timesteps, drone_ctrl, options), max_error);
+    mj_deleteModel(drone);
+    return 0;
+}
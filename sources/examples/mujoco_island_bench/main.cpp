@@ -0,0 +1,86 @@
+#include <mujoco/mujoco.h>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "mujoco_fleet_builder.hpp"
+#include "mujoco_island_stats.hpp"
+#include "mujoco_thread_pool.hpp"
+#include "mujoco_timer.hpp"
+
+// tb3 の群（ロボット同士の接触がない配置）で、制約の島の数・大きさを計測し、
+// 島なし / 島ごと（逐次）/ 島ごと（スレッドプールで並行、実験的）の1ステップの時間を比べる。
+// 使い方: island_bench [model_path] [steps] [nworker] [N ...]
+static void fleet_ctrl(const FleetBuilder& fleet, mjData* data) {
+    for (int r = 0; r < fleet.size(); r++) {
+        mjtNum* ctrl = fleet.ctrl(data, r);
+        for (int i = 0; i < fleet.robot(r).nu; i++) {
+            ctrl[i] = 2.0 + 1.5 * std::sin(data->time + 0.3 * r + i);
+        }
+    }
+}
+
+int main(int argc, const char* argv[]) {
+    std::string model_path = argc > 1 ? argv[1] : "models/tb3.xml";
+    int steps = argc > 2 ? std::stoi(argv[2]) : 1000;
+    int nworker = argc > 3 ? std::stoi(argv[3]) : static_cast<int>(std::thread::hardware_concurrency());
+    std::vector<int> sizes;
+    for (int i = 4; i < argc; i++) {
+        sizes.push_back(std::stoi(argv[i]));
+    }
+    if (sizes.empty()) {
+        sizes = {1, 10, 50, 100};
+    }
+
+    enable_mujoco_timers();
+    WorkerPool pool(nworker);
+    const IslandStepMode modes[] = {IslandStepMode::Off, IslandStepMode::Serial, IslandStepMode::Parallel};
+
+    for (int n : sizes) {
+        FleetOptions options;
+        options.robots = n;
+        options.mode = FleetMode::SharedArena;
+        FleetBuilder fleet;
+        if (!fleet.build(model_path, options)) {
+            return 1;
+        }
+        mjModel* model = fleet.model();
+        std::cout << "[INFO] N=" << n << " nv=" << model->nv << " steps=" << steps << " workers=" << pool.size()
+                  << std::endl;
+
+        for (IslandStepMode mode : modes) {
+            mjData* data = mj_makeData(model);
+            if (!configure_island_stepping(model, data, mode, &pool)) {
+                std::cout << "  " << island_step_mode_name(mode) << ": skipped (no thread pool)" << std::endl;
+                mj_deleteData(data);
+                continue;
+            }
+            // 計測するのは mj_step だけ（制御入力の計算と島の集計は含めない）
+            IslandMonitor monitor;
+            std::chrono::duration<double, std::micro> elapsed(0);
+            for (int s = 0; s < steps; s++) {
+                fleet_ctrl(fleet, data);
+                auto start = std::chrono::steady_clock::now();
+                mj_step(model, data);
+                elapsed += std::chrono::steady_clock::now() - start;
+                if (mode == IslandStepMode::Serial) {
+                    monitor.record(data);
+                }
+            }
+
+            std::cout << "  " << std::setw(8) << island_step_mode_name(mode) << std::fixed << std::setprecision(2)
+                      << "  step=" << elapsed.count() / steps << "us"
+                      << "  constraint=" << mujoco_timer_average_us(data, mjTIMER_CONSTRAINT) << "us"
+                      << "  ncon=" << data->ncon << std::endl;
+            if (mode == IslandStepMode::Serial) {
+                monitor.print(std::cout);
+            }
+            mju_bindThreadPool(data, nullptr);
+            mj_deleteData(data);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,83 @@
+#include <mujoco/mujoco.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "mujoco_linearizer.hpp"
+
+// ホバリング状態のドローンを線形化し、mjd_transitionFD との一致と所要時間を確認する
+static const std::string model_path = "models/drone.xml";
+
+static double elapsed_ms(std::chrono::steady_clock::time_point start) {
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count();
+}
+
+int main(int argc, const char* argv[]) {
+    int nworker = argc > 1 ? std::stoi(argv[1]) : static_cast<int>(std::thread::hardware_concurrency());
+
+    char error[1000];
+    std::cout << "[INFO] Loading model: " << model_path << std::endl;
+    mjModel* model = mj_loadXML(model_path.c_str(), nullptr, error, sizeof(error));
+    if (!model) {
+        std::cerr << "[ERROR] Failed to load model: " << model_path << "\n" << error << std::endl;
+        return 1;
+    }
+    if (model->nu == 0) {
+        std::cerr << "[ERROR] Model has no actuators: " << model_path << std::endl;
+        mj_deleteModel(model);
+        return 1;
+    }
+    mjData* data = mj_makeData(model);
+
+    // ホバリング推力（総質量 × 重力加速度をロータ数で等分）
+    double hover_thrust = mj_getTotalmass(model) * -model->opt.gravity[2] / model->nu;
+    for (int i = 0; i < model->nu; i++) {
+        data->ctrl[i] = hover_thrust;
+    }
+    mj_forward(model, data);
+    std::cout << "[INFO] Hover thrust per rotor: " << hover_thrust << " N" << std::endl;
+
+    Linearizer linearizer(model, nworker);
+    auto start = std::chrono::steady_clock::now();
+    const Linearization& lin = linearizer.linearize(data);
+    double cold_ms = elapsed_ms(start);
+
+    start = std::chrono::steady_clock::now();
+    linearizer.linearize(data);
+    double warm_ms = elapsed_ms(start);
+
+    // mjd_transitionFD（逐次実行）との比較
+    std::vector<mjtNum> A(lin.nx * lin.nx);
+    std::vector<mjtNum> B(lin.nx * lin.nu);
+    mjData* ref_data = mj_makeData(model);
+    mj_copyData(ref_data, model, data);
+    start = std::chrono::steady_clock::now();
+    mjd_transitionFD(model, ref_data, 1e-6, 0, A.data(), B.data(), nullptr, nullptr);
+    double ref_ms = elapsed_ms(start);
+
+    double max_diff = 0;
+    for (size_t i = 0; i < A.size(); i++) {
+        max_diff = std::max(max_diff, std::abs(A[i] - lin.A[i]));
+    }
+    for (size_t i = 0; i < B.size(); i++) {
+        max_diff = std::max(max_diff, std::abs(B[i] - lin.B[i]));
+    }
+
+    std::cout << "[INFO] A: " << lin.nx << "x" << lin.nx << ", B: " << lin.nx << "x" << lin.nu << std::endl;
+    std::cout << "[INFO] Workers: " << nworker
+              << " | linearize (cold): " << cold_ms << " ms"
+              << " | linearize (cached): " << warm_ms << " ms"
+              << " | mjd_transitionFD: " << ref_ms << " ms" << std::endl;
+    std::cout << "[INFO] Max |diff| vs mjd_transitionFD: " << max_diff << std::endl;
+    std::cout << "[INFO] Cache hits: " << linearizer.cache_hits()
+              << ", misses: " << linearizer.cache_misses() << std::endl;
+
+    mj_deleteData(ref_data);
+    mj_deleteData(data);
+    mj_deleteModel(model);
+    return 0;
+}
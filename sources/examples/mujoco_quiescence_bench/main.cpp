@@ -0,0 +1,103 @@
+#include <mujoco/mujoco.h>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include "mujoco_quiescence.hpp"
+#include "mujoco_thread_pool.hpp"
+
+// N 台の tb3 のうち一部だけがその場で旋回し、残りは ctrl=0 で停車している場面で、
+// 全台を進める場合と、静止したロボットを眠らせる場合の1ステップの時間を比べる。
+// 途中で停車中の1台に ctrl を与え、起きて動き出すことも確認する。
+// 使い方: quiescence_bench [model_path] [robots] [driving] [steps] [nworker]
+int main(int argc, const char* argv[]) {
+    std::string model_path = argc > 1 ? argv[1] : "models/tb3.xml";
+    int robots = argc > 2 ? std::stoi(argv[2]) : 100;
+    int driving = argc > 3 ? std::stoi(argv[3]) : 10;
+    int steps = argc > 4 ? std::stoi(argv[4]) : 2000;
+    int nworker = argc > 5 ? std::stoi(argv[5]) : 1;
+
+    char error[1000];
+    mjModel* model = mj_loadXML(model_path.c_str(), nullptr, error, sizeof(error));
+    if (!model) {
+        std::cerr << "[ERROR] Failed to load model: " << model_path << "\n" << error << std::endl;
+        return 1;
+    }
+    if (model->nu < 2 || model->jnt_type[0] != mjJNT_FREE) {
+        std::cerr << "[ERROR] Expected a free-floating robot with two motors: " << model_path << std::endl;
+        mj_deleteModel(model);
+        return 1;
+    }
+    WorkerPool pool(nworker);
+    const double spacing = 1.0;
+    const int columns = static_cast<int>(std::ceil(std::sqrt(robots)));
+    const int woken = robots - 1;  // 途中で動かす停車中のロボット
+
+    // 格子状に並べ、先頭の driving 台はその場で旋回させる
+    auto setup = [&](mjData* d, int r) {
+        d->qpos[model->jnt_qposadr[0] + 0] += spacing * (r % columns);
+        d->qpos[model->jnt_qposadr[0] + 1] += spacing * (r / columns);
+        mj_forward(model, d);
+    };
+    auto drive = [&](mjData* d, int r, int step) {
+        if (r < driving || (r == woken && step >= steps / 2)) {
+            d->ctrl[0] = 3.0;
+            d->ctrl[1] = -3.0;
+        }
+    };
+
+    // 全台を進める
+    double all_us = 0;
+    {
+        SleepingFleet fleet(model, robots);
+        for (int r = 0; r < robots; r++) {
+            setup(fleet.data(r), r);
+        }
+        auto start = std::chrono::steady_clock::now();
+        for (int s = 0; s < steps; s++) {
+            for (int r = 0; r < robots; r++) {
+                drive(fleet.data(r), r, s);
+            }
+            pool.parallel_for(robots, [&](int, int begin, int end) {
+                for (int r = begin; r < end; r++) {
+                    mj_step(model, fleet.data(r));
+                }
+            });
+        }
+        std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+        all_us = elapsed.count() / steps;
+    }
+
+    // 静止したロボットを眠らせる
+    double sleep_us = 0;
+    long long stepped = 0;
+    {
+        SleepingFleet fleet(model, robots);
+        for (int r = 0; r < robots; r++) {
+            setup(fleet.data(r), r);
+        }
+        auto start = std::chrono::steady_clock::now();
+        for (int s = 0; s < steps; s++) {
+            for (int r = 0; r < robots; r++) {
+                drive(fleet.data(r), r, s);
+            }
+            stepped += fleet.step(&pool);
+            if (s == steps / 2 - 1 || s == steps / 2 || s == steps - 1) {
+                std::cout << "[INFO] step=" << s << " active=" << fleet.active() << "/" << robots
+                          << " robot" << woken << (fleet.awake(woken) ? " awake" : " asleep") << std::endl;
+            }
+        }
+        std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+        sleep_us = elapsed.count() / steps;
+    }
+
+    std::cout << std::fixed << std::setprecision(2) << "[INFO] robots=" << robots << " driving=" << driving
+              << " workers=" << pool.size() << std::endl
+              << "  step all : " << all_us << " us/step" << std::endl
+              << "  sleeping : " << sleep_us << " us/step (mean active " << static_cast<double>(stepped) / steps
+              << ")" << std::endl;
+    mj_deleteModel(model);
+    return 0;
+}
@@ -0,0 +1,80 @@
+#include <mujoco/mujoco.h>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include "mujoco_input_recorder.hpp"
+
+// drone の入力記録を再シミュレーションし、チェックポイントのハッシュを照合した後、
+// 指定した時間区間の機体位置を再構成して出力する
+// 使い方: replay [record_path] [begin_sec] [end_sec]
+static const std::string model_path = "models/drone.xml";
+
+int main(int argc, const char* argv[]) {
+    std::string record_path = argc > 1 ? argv[1] : "drone_inputs.mjrec";
+    double begin_sec = argc > 2 ? std::stod(argv[2]) : 0.0;
+    double end_sec = argc > 3 ? std::stod(argv[3]) : begin_sec + 1.0;
+
+    char error[1000];
+    mjModel* model = mj_loadXML(model_path.c_str(), nullptr, error, sizeof(error));
+    if (!model) {
+        std::cerr << "[ERROR] Failed to load model: " << model_path << "\n" << error << std::endl;
+        return 1;
+    }
+    mjData* data = mj_makeData(model);
+
+    InputReplay replay;
+    if (!replay.load(record_path) || !replay.compatible(model)) {
+        std::cerr << "[ERROR] Record does not match model: " << model_path << std::endl;
+        mj_deleteData(data);
+        mj_deleteModel(model);
+        return 1;
+    }
+
+    // **記録サイズ（全状態を毎ステップ保存した場合との比較）**
+    double file_bytes = static_cast<double>(std::filesystem::file_size(record_path));
+    double full_bytes = static_cast<double>(replay.steps()) * replay.header().state_size * sizeof(mjtNum);
+    std::cout << "[INFO] Steps: " << replay.steps() << " (" << replay.duration() << " s"
+              << (replay.variable_timestep() ? ", variable timestep" : "") << ")"
+              << " | checkpoints: " << replay.num_checkpoints() << std::endl;
+    std::cout << "[INFO] Record size: " << file_bytes / 1024 << " KiB | full-state log: " << full_bytes / 1024
+              << " KiB | ratio: " << full_bytes / file_bytes << "x" << std::endl;
+
+    // **全体の照合**
+    int64_t mismatch = replay.verify(model, data);
+    if (mismatch >= 0) {
+        std::cerr << "[ERROR] Replay is not bit-exact (first mismatch at step " << mismatch << ")" << std::endl;
+    } else {
+        std::cout << "[INFO] Replay is bit-exact at all checkpoints." << std::endl;
+    }
+
+    // **区間の再構成**
+    // timestep が可変の場合もあるため、各ステップの timestep を足して時刻からステップを求める
+    int64_t begin = replay.steps();
+    int64_t end = replay.steps();
+    double t = 0;
+    for (int64_t step = 0; step < replay.steps(); step++) {
+        if (begin == replay.steps() && t >= begin_sec) {
+            begin = step;
+        }
+        if (t >= end_sec) {
+            end = step;
+            break;
+        }
+        t += replay.timestep(step);
+    }
+    int body = mj_name2id(model, mjOBJ_BODY, "drone_base");
+    double next_print = begin_sec;
+    bool ok = body != -1 && replay.simulate(model, data, begin, end, [&](int64_t, const mjData* d) {
+        if (d->time >= next_print) {
+            while (next_print <= d->time) {
+                next_print += 0.1;
+            }
+            std::cout << "[Replay] t=" << d->time << " | drone_base: (" << d->xpos[3 * body] << ", "
+                      << d->xpos[3 * body + 1] << ", " << d->xpos[3 * body + 2] << ")" << std::endl;
+        }
+    });
+
+    mj_deleteData(data);
+    mj_deleteModel(model);
+    return ok && mismatch < 0 ? 0 : 1;
+}
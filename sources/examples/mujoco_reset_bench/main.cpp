@@ -0,0 +1,112 @@
+#include <mujoco/mujoco.h>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <string>
+#include "mujoco_reset_pool.hpp"
+
+// エピソードリセットの遅延を比較する
+//  - make:  エピソードごとに mj_makeData / mj_deleteData（従来の方法）
+//  - reset: mj_resetData + mj_forward
+//  - pool:  ResetPool（mj_setState + mj_forward）
+// 使い方: reset_bench [model_path] [episodes] [steps_per_episode]
+
+static double elapsed_us(std::chrono::steady_clock::time_point start, int count) {
+    std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / count;
+}
+
+// 1エピソードぶん進めて状態を変えておく（リセットの計測からは除く）
+static void run_episode(const mjModel* model, mjData* data, int steps) {
+    for (int i = 0; i < steps; i++) {
+        mj_step(model, data);
+    }
+}
+
+int main(int argc, const char* argv[]) {
+    std::string model_path = argc > 1 ? argv[1] : "models/tb3.xml";
+    int episodes = argc > 2 ? std::stoi(argv[2]) : 10000;
+    int steps = argc > 3 ? std::stoi(argv[3]) : 10;
+
+    char error[1000];
+    std::cout << "[INFO] Loading model: " << model_path << std::endl;
+    mjModel* model = mj_loadXML(model_path.c_str(), nullptr, error, sizeof(error));
+    if (!model) {
+        std::cerr << "[ERROR] Failed to load model: " << model_path << "\n" << error << std::endl;
+        return 1;
+    }
+
+    // **初期状態バンク（デフォルト状態 + qpos/qvel に小さな乱数を加えた状態）**
+    ResetPool pool(model);
+    pool.add_default();
+    pool.add_sampled(255, [](const mjModel* m, mjData* d, std::mt19937& rng) {
+        std::normal_distribution<double> noise(0.0, 0.01);
+        for (int i = 0; i < m->nq; i++) {
+            d->qpos[i] += noise(rng);
+        }
+        for (int i = 0; i < m->nv; i++) {
+            d->qvel[i] = noise(rng);
+        }
+    }, 0);
+    std::cout << "[INFO] Reset pool: " << pool.size() << " states x " << pool.state_size() << " values" << std::endl;
+
+    // **make: エピソードごとに mjData を作り直す**
+    double make_us = 0;
+    for (int e = 0; e < episodes; e++) {
+        auto start = std::chrono::steady_clock::now();
+        mjData* d = mj_makeData(model);
+        mj_forward(model, d);
+        make_us += elapsed_us(start, 1);
+        run_episode(model, d, steps);
+        mj_deleteData(d);
+    }
+    make_us /= episodes;
+
+    // **reset: mj_resetData**
+    mjData* data = mj_makeData(model);
+    double reset_us = 0;
+    for (int e = 0; e < episodes; e++) {
+        run_episode(model, data, steps);
+        auto start = std::chrono::steady_clock::now();
+        mj_resetData(model, data);
+        mj_forward(model, data);
+        reset_us += elapsed_us(start, 1);
+    }
+    reset_us /= episodes;
+
+    // **pool: mj_setState**
+    double pool_us = 0;
+    for (int e = 0; e < episodes; e++) {
+        run_episode(model, data, steps);
+        auto start = std::chrono::steady_clock::now();
+        pool.reset(data, e);
+        pool_us += elapsed_us(start, 1);
+    }
+    pool_us /= episodes;
+
+    // **確認: バンクの状態0からのリセットが mj_resetData と同じ結果になるか**
+    mjData* expected = mj_makeData(model);
+    mj_forward(model, expected);
+    run_episode(model, data, steps);
+    pool.reset(data, 0);
+    double max_diff = 0;
+    for (int i = 0; i < model->nq; i++) {
+        max_diff = std::fmax(max_diff, std::fabs(data->qpos[i] - expected->qpos[i]));
+    }
+    for (int i = 0; i < 3 * model->nbody; i++) {
+        max_diff = std::fmax(max_diff, std::fabs(data->xpos[i] - expected->xpos[i]));
+    }
+
+    std::cout << "[INFO] Episodes: " << episodes << " | steps/episode: " << steps << std::endl;
+    std::cout << "[INFO] make (mj_makeData):  " << make_us << " us/reset" << std::endl;
+    std::cout << "[INFO] reset (mj_resetData): " << reset_us << " us/reset" << std::endl;
+    std::cout << "[INFO] pool (mj_setState):  " << pool_us << " us/reset"
+              << " | speedup vs make: " << make_us / pool_us << "x" << std::endl;
+    std::cout << "[INFO] Max difference from mj_resetData state: " << max_diff << std::endl;
+
+    mj_deleteData(expected);
+    mj_deleteData(data);
+    mj_deleteModel(model);
+    return max_diff == 0 ? 0 : 1;
+}
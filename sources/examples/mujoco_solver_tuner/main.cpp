@@ -0,0 +1,109 @@
+#include <mujoco/mujoco.h>
+#include <cmath>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+#include "mujoco_input_recorder.hpp"
+#include "mujoco_solver_tuner.hpp"
+
+// 記録した tb3 のシナリオを制約ソルバの設定格子で再生し、ドリフトの許容値以内で最も速い設定を推奨する
+// 使い方: solver_tuner [drift_tolerance_m] [scenario.mjrec ...]
+//   シナリオを指定しない場合は、接触の多い組み込みシナリオを記録してから使う
+static const std::string model_path = "models/tb3.xml";
+
+// 組み込みシナリオ: 急加速・その場旋回・前後の切り返し
+struct ScriptedScenario {
+    std::string name;
+    std::function<void(double t, mjtNum* ctrl)> ctrl;
+};
+
+static bool record_scenario(const mjModel* model, const ScriptedScenario& scenario, const std::string& path,
+                            double duration) {
+    mjData* data = mj_makeData(model);
+    mj_forward(model, data);
+    InputRecorder recorder(model);
+    if (!recorder.open(path)) {
+        mj_deleteData(data);
+        return false;
+    }
+    int64_t steps = static_cast<int64_t>(duration / model->opt.timestep);
+    for (int64_t i = 0; i < steps; i++) {
+        scenario.ctrl(data->time, data->ctrl);
+        recorder.record(data);
+        mj_step(model, data);
+    }
+    recorder.close(data);
+    mj_deleteData(data);
+    std::cout << "[INFO] Recorded scenario '" << scenario.name << "': " << path << std::endl;
+    return true;
+}
+
+int main(int argc, const char* argv[]) {
+    double drift_tolerance = argc > 1 ? std::stod(argv[1]) : 0.005;
+    std::vector<std::string> paths;
+    for (int i = 2; i < argc; i++) {
+        paths.push_back(argv[i]);
+    }
+
+    char error[1000];
+    mjModel* model = mj_loadXML(model_path.c_str(), nullptr, error, sizeof(error));
+    if (!model) {
+        std::cerr << "[ERROR] Failed to load model: " << model_path << "\n" << error << std::endl;
+        return 1;
+    }
+
+    // **シナリオの準備**
+    if (paths.empty()) {
+        std::vector<ScriptedScenario> scripted = {
+            {"launch", [](double t, mjtNum* ctrl) { ctrl[0] = ctrl[1] = t < 1.0 ? 10.0 : 4.0; }},
+            {"spin", [](double, mjtNum* ctrl) { ctrl[0] = 10.0; ctrl[1] = -10.0; }},
+            {"reversal", [](double t, mjtNum* ctrl) { ctrl[0] = ctrl[1] = std::fmod(t, 2.0) < 1.0 ? 10.0 : -10.0; }},
+        };
+        for (const ScriptedScenario& scenario : scripted) {
+            std::string path = "tb3_scenario_" + scenario.name + ".mjrec";
+            if (!record_scenario(model, scenario, path, 20.0)) {
+                mj_deleteModel(model);
+                return 1;
+            }
+            paths.push_back(path);
+        }
+    }
+    std::vector<std::unique_ptr<InputReplay>> replays;
+    std::vector<const InputReplay*> scenarios;
+    for (const std::string& path : paths) {
+        replays.emplace_back(new InputReplay());
+        if (!replays.back()->load(path)) {
+            mj_deleteModel(model);
+            return 1;
+        }
+        scenarios.push_back(replays.back().get());
+    }
+
+    // **格子探索**
+    std::vector<SolverSettings> grid = make_solver_grid();
+    SolverSettings current = {model->opt.solver, model->opt.iterations, model->opt.tolerance,
+                              model->opt.ls_iterations, model->opt.jacobian};
+    grid.push_back(current);
+    std::cout << "[INFO] " << grid.size() << " settings x " << scenarios.size() << " scenarios" << std::endl;
+    std::vector<SolverTrialResult> results = tune_solver(model, scenarios, grid);
+    mj_deleteModel(model);
+    if (results.empty()) {
+        return 1;
+    }
+
+    print_solver_table(results, std::cout);
+    const SolverTrialResult& baseline = results.back();
+    std::cout << "[INFO] Current: " << solver_settings_label(baseline.settings) << " | constraint "
+              << baseline.constraint_us << " us/step | drift " << baseline.drift << " m" << std::endl;
+    const SolverTrialResult* best = recommend_solver(results, drift_tolerance);
+    if (!best) {
+        std::cout << "[INFO] No settings within drift " << drift_tolerance << " m" << std::endl;
+        return 1;
+    }
+    std::cout << "[INFO] Recommended (drift <= " << drift_tolerance << " m): " << solver_settings_label(best->settings)
+              << " | constraint " << best->constraint_us << " us/step (" << baseline.constraint_us / best->constraint_us
+              << "x)" << std::endl;
+    return 0;
+}
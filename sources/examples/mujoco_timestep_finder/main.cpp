@@ -0,0 +1,86 @@
+#include <mujoco/mujoco.h>
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "mujoco_timestep_finder.hpp"
+
+// MJCF ごとに、台本どおりの制御プロファイルの全てで安定に動く最大の timestep を探す
+// 使い方: timestep_finder [model_path] [out_path] [safety_factor]
+//   out_path を指定すると、見つけた timestep に safety_factor を掛けた値を mjSpec 経由で書き込む
+
+static double ctrl_lo(const mjModel* m, int i) {
+    return m->actuator_ctrllimited[i] ? m->actuator_ctrlrange[2 * i] : -1.0;
+}
+
+static double ctrl_hi(const mjModel* m, int i) {
+    return m->actuator_ctrllimited[i] ? m->actuator_ctrlrange[2 * i + 1] : 1.0;
+}
+
+// 制御範囲だけを使うプロファイル（どのモデルにも使える）
+static std::vector<ControlProfile> make_profiles() {
+    std::vector<ControlProfile> profiles;
+    profiles.push_back({"full", [](const mjModel* m, const mjData*, mjtNum* ctrl) {
+        for (int i = 0; i < m->nu; i++) {
+            ctrl[i] = ctrl_hi(m, i);
+        }
+    }});
+    profiles.push_back({"opposed", [](const mjModel* m, const mjData*, mjtNum* ctrl) {
+        for (int i = 0; i < m->nu; i++) {
+            ctrl[i] = i % 2 == 0 ? ctrl_hi(m, i) : ctrl_lo(m, i);
+        }
+    }});
+    profiles.push_back({"bang-bang 2Hz", [](const mjModel* m, const mjData* d, mjtNum* ctrl) {
+        bool high = std::fmod(d->time * 2.0, 1.0) < 0.5;
+        for (int i = 0; i < m->nu; i++) {
+            ctrl[i] = (high == (i % 2 == 0)) ? ctrl_hi(m, i) : ctrl_lo(m, i);
+        }
+    }});
+    profiles.push_back({"chirp 0.1-5Hz", [](const mjModel* m, const mjData* d, mjtNum* ctrl) {
+        double phase = 2.0 * M_PI * (0.1 * d->time + 0.25 * d->time * d->time);
+        for (int i = 0; i < m->nu; i++) {
+            double lo = ctrl_lo(m, i);
+            double hi = ctrl_hi(m, i);
+            ctrl[i] = 0.5 * (lo + hi) + 0.5 * (hi - lo) * std::sin(phase + i);
+        }
+    }});
+    return profiles;
+}
+
+int main(int argc, const char* argv[]) {
+    std::string model_path = argc > 1 ? argv[1] : "models/tb3.xml";
+    std::string out_path = argc > 2 ? argv[2] : "";
+    double safety = argc > 3 ? std::stod(argv[3]) : 0.8;
+
+    char error[1000];
+    std::cout << "[INFO] Loading model: " << model_path << std::endl;
+    mjModel* model = mj_loadXML(model_path.c_str(), nullptr, error, sizeof(error));
+    if (!model) {
+        std::cerr << "[ERROR] Failed to load model: " << model_path << "\n" << error << std::endl;
+        return 1;
+    }
+
+    std::vector<ControlProfile> profiles = make_profiles();
+    TimestepSearchResult result = find_stable_timestep(model, profiles);
+    std::cout << "[INFO] Current timestep: " << model->opt.timestep << " | trials: " << result.trials << std::endl;
+    mj_deleteModel(model);
+    if (!result.found) {
+        return 1;
+    }
+
+    std::cout << "[INFO] Largest stable timestep: " << result.timestep << std::endl;
+    if (result.unstable_timestep > 0) {
+        std::cout << "[INFO] Unstable from: " << result.unstable_timestep << " (profile '" << result.failed_profile
+                  << "')" << std::endl;
+    }
+
+    double recommended = result.timestep * safety;
+    std::cout << "[INFO] Recommended timestep (x" << safety << "): " << recommended << std::endl;
+    if (!out_path.empty()) {
+        if (!write_timestep(model_path, out_path, recommended)) {
+            return 1;
+        }
+        std::cout << "[INFO] Wrote " << out_path << std::endl;
+    }
+    return 0;
+}
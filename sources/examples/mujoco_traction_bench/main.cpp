@@ -0,0 +1,109 @@
+#include <mujoco/mujoco.h>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "mujoco_timer.hpp"
+#include "tb3_traction_plugin.hpp"
+
+// 車輪の接触を制約ソルバで解く tb3.xml と、hakoniwa.tb3_traction プラグインで置き換えた tb3_traction.xml を
+// 同じ制御プロファイルで走らせ、1ステップの時間・制約計算の時間・最終位置の差を比べる
+// 使い方: traction_bench [duration_s]
+static const std::string contact_path = "models/tb3.xml";
+static const std::string traction_path = "models/tb3_traction.xml";
+
+struct Profile {
+    std::string name;
+    std::function<void(double t, mjtNum* ctrl)> ctrl;
+};
+
+struct DriveResult {
+    double ns_per_step = 0;
+    double constraint_us = 0;
+    double nefc = 0;
+    double x = 0, y = 0, yaw = 0;
+};
+
+static mjModel* load_model(const std::string& path) {
+    char error[1000];
+    mjModel* model = mj_loadXML(path.c_str(), nullptr, error, sizeof(error));
+    if (!model) {
+        std::cerr << "[ERROR] Failed to load model: " << path << "\n" << error << std::endl;
+    }
+    return model;
+}
+
+static DriveResult drive(const mjModel* m, const Profile& profile, double duration) {
+    DriveResult result;
+    mjData* d = mj_makeData(m);
+    mj_forward(m, d);
+    std::memset(d->timer, 0, sizeof(d->timer));
+    int64_t steps = static_cast<int64_t>(duration / m->opt.timestep);
+    double nefc = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int64_t i = 0; i < steps; i++) {
+        profile.ctrl(d->time, d->ctrl);
+        mj_step(m, d);
+        nefc += d->nefc;
+    }
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    result.ns_per_step = elapsed.count() / static_cast<double>(steps);
+    result.constraint_us = mujoco_timer_average_us(d, mjTIMER_CONSTRAINT);
+    result.nefc = nefc / static_cast<double>(steps);
+
+    int base = mj_name2id(m, mjOBJ_BODY, "tb3_base");
+    const mjtNum* q = d->xquat + 4 * base;
+    result.x = d->xpos[3 * base];
+    result.y = d->xpos[3 * base + 1];
+    result.yaw = std::atan2(2.0 * (q[0] * q[3] + q[1] * q[2]), 1.0 - 2.0 * (q[2] * q[2] + q[3] * q[3]));
+    mj_deleteData(d);
+    return result;
+}
+
+int main(int argc, const char* argv[]) {
+    double duration = argc > 1 ? std::stod(argv[1]) : 10.0;
+    if (!register_tb3_traction_plugin()) {
+        return 1;
+    }
+    enable_mujoco_timers();
+    mjModel* contact = load_model(contact_path);
+    mjModel* traction = contact ? load_model(traction_path) : nullptr;
+    if (!contact || !traction) {
+        if (contact) {
+            mj_deleteModel(contact);
+        }
+        return 1;
+    }
+
+    std::vector<Profile> profiles = {
+        {"straight", [](double, mjtNum* ctrl) { ctrl[0] = ctrl[1] = 2.0; }},
+        {"spin", [](double, mjtNum* ctrl) { ctrl[0] = 2.0; ctrl[1] = -2.0; }},
+        {"slalom", [](double t, mjtNum* ctrl) {
+            ctrl[0] = 2.0 + 1.5 * std::sin(t);
+            ctrl[1] = 2.0 - 1.5 * std::sin(t);
+        }},
+    };
+
+    std::cout << std::fixed << std::setprecision(3);
+    for (const Profile& profile : profiles) {
+        DriveResult a = drive(contact, profile, duration);
+        DriveResult b = drive(traction, profile, duration);
+        double dyaw = std::remainder(b.yaw - a.yaw, 2.0 * M_PI);
+        std::cout << "[INFO] " << std::left << std::setw(9) << profile.name << std::right << " contact: "
+                  << std::setw(9) << a.ns_per_step << " ns/step, constraint " << a.constraint_us << " us, nefc "
+                  << a.nefc << " | traction: " << std::setw(9) << b.ns_per_step << " ns/step, constraint "
+                  << b.constraint_us << " us, nefc " << b.nefc << std::endl;
+        std::cout << "[INFO] " << std::left << std::setw(9) << profile.name << std::right << " speedup "
+                  << a.ns_per_step / b.ns_per_step << "x | final pose: contact (" << a.x << ", " << a.y << ", "
+                  << a.yaw << ") traction (" << b.x << ", " << b.y << ", " << b.yaw << ") | position diff "
+                  << std::hypot(b.x - a.x, b.y - a.y) << " m, yaw diff " << dyaw << " rad" << std::endl;
+    }
+
+    mj_deleteModel(traction);
+    mj_deleteModel(contact);
+    return 0;
+}
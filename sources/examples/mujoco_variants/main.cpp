@@ -0,0 +1,76 @@
+#include <mujoco/mujoco.h>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+#include "mujoco_model_cache.hpp"
+#include "mujoco_variant_builder.hpp"
+
+// drone.xml のアーム長を変えたバリアントを並列にコンパイルし、逐次コンパイルと時間を比較する
+// 使い方: variants [count] [nworker]
+static const std::string model_path = "models/drone.xml";
+
+static const char* arm_bodies[] = {"arm1", "arm2", "arm3", "arm4"};
+static const char* arm_geoms[] = {"arm_geom1", "arm_geom2", "arm_geom3", "arm_geom4"};
+
+// アーム長を 0.8〜1.2 倍に変更する
+static bool scale_arms(mjSpec* spec, int index, int count) {
+    double scale = count > 1 ? 0.8 + 0.4 * index / (count - 1) : 1.0;
+    for (int i = 0; i < 4; i++) {
+        mjsBody* arm = mjs_findBody(spec, arm_bodies[i]);
+        mjsElement* element = mjs_findElement(spec, mjOBJ_GEOM, arm_geoms[i]);
+        if (!arm || !element) {
+            std::cerr << "[ERROR] Arm not found: " << arm_bodies[i] << std::endl;
+            return false;
+        }
+        arm->pos[0] *= scale;
+        arm->pos[1] *= scale;
+        mjs_asGeom(element)->size[1] *= scale;
+    }
+    return true;
+}
+
+static double build_variants(int count, int nworker, ModelCache& cache, int& built) {
+    VariantBuilder builder(nworker);
+    if (!builder.load(model_path)) {
+        return -1;
+    }
+    auto start = std::chrono::steady_clock::now();
+    built = builder.build(
+        count,
+        [count](mjSpec* spec, int index) { return scale_arms(spec, index, count); },
+        [](int index) { return "drone_arm_" + std::to_string(index); },
+        cache);
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count();
+}
+
+int main(int argc, const char* argv[]) {
+    int count = argc > 1 ? std::stoi(argv[1]) : 1000;
+    int nworker = argc > 2 ? std::stoi(argv[2]) : static_cast<int>(std::thread::hardware_concurrency());
+
+    ModelCache serial_cache;
+    int serial_built = 0;
+    double serial_s = build_variants(count, 1, serial_cache, serial_built);
+    if (serial_s < 0) {
+        return 1;
+    }
+
+    ModelCache cache;
+    int built = 0;
+    double parallel_s = build_variants(count, nworker, cache, built);
+
+    std::cout << "[INFO] Variants: " << count << std::endl;
+    std::cout << "[INFO] Serial: " << serial_built << " built in " << serial_s << " s" << std::endl;
+    std::cout << "[INFO] Parallel (" << nworker << " workers): " << built << " built in " << parallel_s << " s"
+              << " | speedup: " << serial_s / parallel_s << "x" << std::endl;
+
+    const mjModel* first = cache.find("drone_arm_0");
+    const mjModel* last = cache.find("drone_arm_" + std::to_string(count - 1));
+    if (first && last) {
+        int arm = mj_name2id(first, mjOBJ_BODY, "arm1");
+        std::cout << "[INFO] arm1 x: " << first->body_pos[3 * arm] << " (variant 0) -> "
+                  << last->body_pos[3 * arm] << " (variant " << count - 1 << ")" << std::endl;
+    }
+    return 0;
+}